@@ -20,8 +20,6 @@ public class GraphToDungeonEditor : ModuleRules
 				// ... add other private include paths required here ...
 				"GraphToDungeonEditor/Private",
                 "GraphToDungeonEditor/Public",
-                "GraphToDungeonEditor/Private/Graph",
-                "GraphToDungeonEditor/Public/Graph",
 				"GraphToDungeonEditor/Private/AssetTypeActions",
                 "GraphToDungeonEditor/Public/AssetTypeActions",
                 "GraphToDungeonEditor/Private/Factories",
@@ -52,6 +50,7 @@ public class GraphToDungeonEditor : ModuleRules
 				"Slate",
 				"SlateCore",
 				"GenericGraphRuntime",
+				"GraphToDungeonRuntime",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
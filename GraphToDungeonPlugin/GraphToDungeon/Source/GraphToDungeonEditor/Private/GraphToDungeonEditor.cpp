@@ -5,7 +5,13 @@
 #include "GraphToDungeonStyle.h"
 #include "GraphToDungeonCommands.h"
 #include "GraphToDungeonProperties.h"
+#include "LevelGraphSession.h"
 #include "GraphToDungeonGenerator.h"
+#include "DungeonLayout.h"
+#include "DungeonLayoutCache.h"
+#include "Async/ParallelFor.h"
+#include "UObject/StrongObjectPtr.h"
+#include "LevelEditorViewport.h"
 
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Layout/SBox.h"
@@ -19,6 +25,81 @@
 
 static const FName GraphToDungeonTabName("GraphToDungeon");
 
+// Fresh seed for random seed mode, generation itself only ever uses seeds derived from it
+static int32 MakeRandomSeed()
+{
+	FRandomStream SeedStream;
+	SeedStream.GenerateNewSeed();
+	return SeedStream.GetCurrentSeed();
+}
+
+/**
+ * @brief Generation running on a background task, the task writes results before setting bFinished
+ * and the game thread reads them only after seeing it set. Owned by the game thread, which also destroys it
+ */
+struct FGenerationJob
+{
+	// Assets the job was started from, kept alive for the spawn, the task never touches them
+	TStrongObjectPtr<ULevelGraphSession> LevelGraph;
+	TStrongObjectPtr<UGraphToDungeonProperties> LevelProperties;
+	// Generation inputs, copied on the game thread so graph edits during generation do not affect the task
+	FDungeonLayoutInput Input;
+	int32 BaseSeed = 0;
+	int32 MaxAttempts = 0;
+	bool bUseLayoutCache = false;
+	uint64 InputHash = 0;
+	// Attempts without cache entry, ascending, the only ones generated
+	TArray<int32> MissingAttempts;
+	// Lowest attempt with cached layout, every attempt before it is missing or a cached failure
+	int32 CachedAttempt = INDEX_NONE;
+	FDungeonLayout CachedLayout;
+
+	// Progress of the batch being generated
+	FDungeonLayoutProgress Progress;
+	std::atomic<int32> Attempt{ 0 };
+	std::atomic<bool> bFinished{ false };
+
+	// Results of fully generated batches in attempt order
+	TArray<int32> GeneratedAttempts;
+	TArray<FDungeonLayout> GeneratedLayouts;
+	TArray<bool> GeneratedSuccesses;
+
+	/**
+	 * @brief Generates missing attempts in batches of worker thread count until one succeeds, runs on the background task
+	 */
+	void Run()
+	{
+		const int32 BatchSize = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+		for (int32 BatchStart = 0; BatchStart < MissingAttempts.Num(); BatchStart += BatchSize)
+		{
+			const int32 BatchCount = FMath::Min(BatchSize, MissingAttempts.Num() - BatchStart);
+			TArray<FDungeonLayout> Layouts;
+			Layouts.SetNum(BatchCount);
+			TArray<bool> Successes;
+			Successes.Init(false, BatchCount);
+			Progress.Reset();
+			Attempt = MissingAttempts[BatchStart + BatchCount - 1] + 1;
+			ParallelFor(BatchCount, [&](const int32 Index)
+				{
+					Successes[Index] = FDungeonLayout::Generate(Input, BaseSeed + MissingAttempts[BatchStart + Index],
+						Layouts[Index], &Progress);
+				});
+			// Attempts stopped by cancellation did not really fail, so the batch is dropped
+			if (Progress.bCancelled) break;
+			bool bAnySuccess = false;
+			for (int32 Index = 0; Index < BatchCount; Index++)
+			{
+				GeneratedAttempts.Add(MissingAttempts[BatchStart + Index]);
+				GeneratedLayouts.Add(MoveTemp(Layouts[Index]));
+				GeneratedSuccesses.Add(Successes[Index]);
+				bAnySuccess |= Successes[Index];
+			}
+			if (bAnySuccess) break;
+		}
+		bFinished = true;
+	}
+};
+
 #define LOCTEXT_NAMESPACE "FGraphToDungeonModule"
 
 void FGraphToDungeonModule::StartupModule()
@@ -71,6 +152,15 @@ void FGraphToDungeonModule::ShutdownModule()
 	FGraphToDungeonCommands::Unregister();
 
 	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(GraphToDungeonTabName);
+
+	// Job has to outlive the background task reading it
+	if (GenerationJob)
+	{
+		GenerationJob->Progress.bCancelled = true;
+		GenerationTask.Wait();
+		FTSTicker::GetCoreTicker().RemoveTicker(GenerationTickerHandle);
+		GenerationJob.Reset();
+	}
 }
 
 void FGraphToDungeonModule::GenerateDungeon()
@@ -80,36 +170,133 @@ void FGraphToDungeonModule::GenerateDungeon()
 		InfoTextBlock->SetText(FText::FromString(TEXT("Not all meshes inside global theme are defined.")));
 		return;
 	}
-	int32 Retries = 0;
-	do
+	// Attempt i always uses seed BaseSeed + i and the lowest successful attempt wins,
+	// so the result does not depend on thread timing
+	GenerationJob = MakeShared<FGenerationJob, ESPMode::ThreadSafe>();
+	GenerationJob->LevelGraph.Reset(Properties->LevelGraph);
+	GenerationJob->LevelProperties.Reset(Properties);
+	GenerationJob->Input = FDungeonLayoutInput::Make(Properties->LevelGraph, Properties);
+	GenerationJob->BaseSeed = Properties->bUseRandomThemeSeed ? MakeRandomSeed() : Properties->ThemeSeed;
+	GenerationJob->MaxAttempts = Properties->MaxGenerationRetries;
+	// Random base seeds are practically never drawn again, their entries would only fill the cache directory
+	GenerationJob->bUseLayoutCache = Properties->bUseLayoutCache && !Properties->bUseRandomThemeSeed;
+	// Cache is read on the game thread because loading a layout resolves its themes,
+	// attempts after the first cached success can never win so they are not even looked up
+	if (GenerationJob->bUseLayoutCache)
 	{
-		if (Properties->bUseRandomThemeSeed)
+		GenerationJob->InputHash = FDungeonLayoutCache::HashInputs(GenerationJob->Input);
+		for (int32 Attempt = 0; Attempt < GenerationJob->MaxAttempts && GenerationJob->CachedAttempt == INDEX_NONE; Attempt++)
 		{
-			Properties->RandomStream.GenerateNewSeed();
-			Properties->ThemeSeed = Properties->RandomStream.GetCurrentSeed();
+			switch (FDungeonLayoutCache::Find(GenerationJob->InputHash, GenerationJob->BaseSeed + Attempt, GenerationJob->CachedLayout))
+			{
+			case FDungeonLayoutCache::EEntry::Missing:
+				GenerationJob->MissingAttempts.Add(Attempt);
+				break;
+			case FDungeonLayoutCache::EEntry::Success:
+				GenerationJob->CachedAttempt = Attempt;
+				break;
+			case FDungeonLayoutCache::EEntry::Failure:
+				break;
+			}
 		}
-		else
+	}
+	else
+	{
+		for (int32 Attempt = 0; Attempt < GenerationJob->MaxAttempts; Attempt++) GenerationJob->MissingAttempts.Add(Attempt);
+	}
+
+	// Task only borrows the job so that its strong object pointers are always released on the game thread
+	GenerationTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job = GenerationJob.Get()]() { Job->Run(); });
+	GenerationTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FGraphToDungeonModule::TickGeneration));
+	UpdateButtonsStatus();
+	InfoTextBlock->SetText(FText::FromString(TEXT("Generating.")));
+}
+
+bool FGraphToDungeonModule::TickGeneration(float DeltaTime)
+{
+	if (!GenerationJob->bFinished)
+	{
+		InfoTextBlock->SetText(FText::FormatOrdered(FText::FromString(TEXT("Generating, retry {0} of {1}.\n{2} rooms placed, {3} corridors routed.")),
+			FMath::Max(1, GenerationJob->Attempt.load()), GenerationJob->MaxAttempts,
+			GenerationJob->Progress.RoomsPlaced.load(), GenerationJob->Progress.CorridorsRouted.load()));
+		return true;
+	}
+	FinishGeneration();
+	return false;
+}
+
+void FGraphToDungeonModule::FinishGeneration()
+{
+	// Task has set bFinished as its last access, waiting only lets it return
+	GenerationTask.Wait();
+	TSharedPtr<FGenerationJob, ESPMode::ThreadSafe> Job = MoveTemp(GenerationJob);
+	UpdateButtonsStatus();
+	if (Job->bUseLayoutCache)
+	{
+		for (int32 Index = 0; Index < Job->GeneratedAttempts.Num(); Index++)
 		{
-			Properties->RandomStream = FRandomStream(Properties->ThemeSeed);
+			FDungeonLayoutCache::Store(Job->InputHash, Job->BaseSeed + Job->GeneratedAttempts[Index],
+				Job->GeneratedSuccesses[Index] ? &Job->GeneratedLayouts[Index] : nullptr);
 		}
-		Retries++;
-	} while (!Generator->Generate(Properties) && Retries < Properties->MaxGenerationRetries);
-	if (Retries == Properties->MaxGenerationRetries)
+	}
+	if (Job->Progress.bCancelled)
+	{
+		InfoTextBlock->SetText(FText::FromString(TEXT("Generation cancelled.")));
+		return;
+	}
+
+	// Generated attempts all precede the cached one, so the first generated success wins
+	const int32 WinningIndex = Job->GeneratedSuccesses.Find(true);
+	const int32 WinningAttempt = WinningIndex != INDEX_NONE ? Job->GeneratedAttempts[WinningIndex] : Job->CachedAttempt;
+	if (WinningAttempt == INDEX_NONE)
 	{
 		InfoTextBlock->SetText(FText::FromString(TEXT("Generation unsuccessful try again or simplify graph.")));
+		return;
+	}
+	// Generator may have been deleted or its level closed while the task ran
+	if (!IsGeneratorSpawned())
+	{
+		InfoTextBlock->SetText(FText::FromString(TEXT("Generator was deleted during generation.")));
+		return;
 	}
-	else 
+	int32 CachedAttempts = WinningAttempt + 1;
+	for (const int32 Attempt : Job->GeneratedAttempts)
 	{
-		InfoTextBlock->SetText(FText::FormatOrdered(FText::FromString(TEXT("Generation successful in {0} retries.")), Retries));
+		if (Attempt <= WinningAttempt) CachedAttempts--;
 	}
+	const int32 WinningSeed = Job->BaseSeed + WinningAttempt;
+	if (Job->LevelProperties->bUseRandomThemeSeed) Job->LevelProperties->ThemeSeed = WinningSeed;
+	// Time sliced spawning starts with rooms nearest to the editor camera
+	TOptional<FVector> FocusLocation;
+	if (GCurrentLevelEditingViewportClient) FocusLocation = GCurrentLevelEditingViewportClient->GetViewLocation();
+	// Stats are shown by HandleSpawningFinished, right away or once time sliced spawning is done
+	SpawnPendingText = FText::FormatOrdered(FText::FromString(TEXT("Generation successful in {0} retries ({1} cached).")),
+		WinningAttempt + 1, CachedAttempts);
+	InfoTextBlock->SetText(FText::Format(FText::FromString(TEXT("{0}\nMeshes are spawned over the next frames.")), SpawnPendingText));
+	Generator->SpawnLayout(Job->LevelProperties.Get(),
+		MoveTemp(WinningIndex != INDEX_NONE ? Job->GeneratedLayouts[WinningIndex] : Job->CachedLayout), WinningSeed, FocusLocation);
+}
+
+void FGraphToDungeonModule::HandleSpawningFinished()
+{
+	// Theme regeneration spawns too, but has no generation result to show
+	if (SpawnPendingText.IsEmpty()) return;
+	InfoTextBlock->SetText(FText::FormatOrdered(FText::FromString(TEXT("{0}\n{1} components, {2} draw calls.")),
+		SpawnPendingText, Generator->GetSpawnedComponentCount(), Generator->GetSpawnedDrawCallCount()));
+	SpawnPendingText = FText::GetEmpty();
 }
 
 FReply FGraphToDungeonModule::OnGenerateNewLevelButtonClicked()
 {
 	World = GEngine->GetWorldContextFromGameViewport(GEngine->GameViewport)->World();
-	if (Generator) Generator->OnGeneratorDeleted.Unbind();
+	if (Generator)
+	{
+		Generator->OnGeneratorDeleted.Unbind();
+		Generator->OnSpawningFinished.Unbind();
+	}
 	Generator = (AGraphToDungeonGenerator*)World->SpawnActor(AGraphToDungeonGenerator::StaticClass());
 	Generator->OnGeneratorDeleted.BindRaw(this, &FGraphToDungeonModule::HandleGeneratorDeleted);
+	Generator->OnSpawningFinished.BindRaw(this, &FGraphToDungeonModule::HandleSpawningFinished);
 
 	UpdateButtonsStatus();
 
@@ -132,22 +319,22 @@ FReply FGraphToDungeonModule::OnRegenerateLevelButtonClicked()
 
 FReply FGraphToDungeonModule::OnRegenerateThemeButtonClicked()
 {
-	if (Properties->bUseRandomThemeSeed)
-	{
-		Properties->RandomStream.GenerateNewSeed();
-		Properties->ThemeSeed = Properties->RandomStream.GetCurrentSeed();
-	}
-	else
-	{
-		Properties->RandomStream = FRandomStream(Properties->ThemeSeed);
-	}
-	Generator->RegenerateTheme();
+	if (Properties->bUseRandomThemeSeed) Properties->ThemeSeed = MakeRandomSeed();
+	Generator->RegenerateTheme(Properties->ThemeSeed);
+	return FReply::Handled();
+}
+
+FReply FGraphToDungeonModule::OnCancelButtonClicked()
+{
+	// Background task stops at its next placement step, TickGeneration then finishes it
+	if (GenerationJob) GenerationJob->Progress.bCancelled = true;
 	return FReply::Handled();
 }
 
 void FGraphToDungeonModule::HandleGeneratorDeleted()
 {
 	Generator = nullptr;
+	SpawnPendingText = FText::GetEmpty();
 	UpdateButtonsStatus();
 }
 
@@ -177,12 +364,18 @@ bool FGraphToDungeonModule::IsGeneratorSpawned() const
 	return Generator &&	World == GEngine->GetWorldContextFromGameViewport(GEngine->GameViewport)->World();
 }
 
+bool FGraphToDungeonModule::IsGenerating() const
+{
+	return GenerationJob.IsValid();
+}
+
 void FGraphToDungeonModule::UpdateButtonsStatus() const
 {
-	GenerateNewLevelButton->SetEnabled(IsPropertiesDefined());
-	RegenerateLevelButton->SetEnabled(IsPropertiesDefined() && IsGeneratorSpawned());
-	RegenerateThemeButton->SetEnabled(IsPropertiesDefined() && IsGeneratorSpawned());
-	DeleteLevelButton->SetEnabled(IsPropertiesDefined() && IsGeneratorSpawned());
+	GenerateNewLevelButton->SetEnabled(!IsGenerating() && IsPropertiesDefined());
+	RegenerateLevelButton->SetEnabled(!IsGenerating() && IsPropertiesDefined() && IsGeneratorSpawned());
+	RegenerateThemeButton->SetEnabled(!IsGenerating() && IsPropertiesDefined() && IsGeneratorSpawned());
+	DeleteLevelButton->SetEnabled(!IsGenerating() && IsPropertiesDefined() && IsGeneratorSpawned());
+	CancelButton->SetEnabled(IsGenerating());
 }
 
 TSharedRef<SDockTab> FGraphToDungeonModule::OnSpawnPluginTab(const FSpawnTabArgs& SpawnTabArgs)
@@ -286,6 +479,16 @@ TSharedRef<SDockTab> FGraphToDungeonModule::OnSpawnPluginTab(const FSpawnTabArgs
 										.OnClicked_Raw(this,
 											&FGraphToDungeonModule::OnDeleteLevelButtonClicked)
 								]
+								+ SHorizontalBox::Slot()
+								.VAlign(VAlign_Top)
+								[
+									SAssignNew(CancelButton, SButton)
+										.Text(FText::FromString("Cancel"))
+										.HAlign(HAlign_Center)
+										.IsEnabled(IsGenerating())
+										.OnClicked_Raw(this,
+											&FGraphToDungeonModule::OnCancelButtonClicked)
+								]
 						]
 				]
 		];
@@ -6,11 +6,14 @@
 #include "IAssetTools.h"
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Containers/Ticker.h"
+#include "Tasks/Task.h"
 
 class FToolBarBuilder;
 class FMenuBuilder;
 class UGraphToDungeonProperties;
 class AGraphToDungeonGenerator;
+struct FGenerationJob;
 
 /**
  * @brief Main class controling generation and defining UI
@@ -37,12 +40,14 @@ private:
 	FReply OnDeleteLevelButtonClicked();
 	FReply OnRegenerateLevelButtonClicked();
 	FReply OnRegenerateThemeButtonClicked();
+	FReply OnCancelButtonClicked();
 	void HandleGeneratorDeleted();
 
 	/** Helper functions*/
 	FString GetPropertiesPath() const;
 	bool IsPropertiesDefined() const;
 	bool IsGeneratorSpawned() const;
+	bool IsGenerating() const;
 
 	/**
 	 * @brief Updates activity status of all buttons at once
@@ -50,16 +55,34 @@ private:
 	void UpdateButtonsStatus() const;
 
 	/**
-	 * @brief Calls Generator to launch generation
+	 * @brief Launches layout generation on a background task, the layout is spawned by TickGeneration once done
 	 */
 	void GenerateDungeon();
 
+	/**
+	 * @brief Shows progress of the running generation and finishes it on the game thread
+	 * @param DeltaTime Unused
+	 * @return True - generation still runs, False - finished and the ticker is removed
+	 */
+	bool TickGeneration(float DeltaTime);
+
+	/**
+	 * @brief Stores generated seeds in the layout cache and spawns the winning layout
+	 */
+	void FinishGeneration();
+
+	/**
+	 * @brief Shows the result of the finished generation with spawn stats, called by the generator once all meshes are spawned
+	 */
+	void HandleSpawningFinished();
+
 private:
 	// Tab buttons
 	TSharedPtr<SButton> GenerateNewLevelButton;
 	TSharedPtr<SButton> DeleteLevelButton;
 	TSharedPtr<SButton> RegenerateLevelButton;
 	TSharedPtr<SButton> RegenerateThemeButton;
+	TSharedPtr<SButton> CancelButton;
 	TSharedPtr<STextBlock> InfoTextBlock;
 
 	TSharedPtr<FAssetThumbnailPool> AssetThumbnailPool;
@@ -72,4 +95,11 @@ private:
 	AGraphToDungeonGenerator* Generator;
 
 	UGraphToDungeonProperties* Properties;
+
+	// Running generation, shared with its background task
+	TSharedPtr<FGenerationJob, ESPMode::ThreadSafe> GenerationJob;
+	UE::Tasks::FTask GenerationTask;
+	FTSTicker::FDelegateHandle GenerationTickerHandle;
+	// Result of the last generation waiting for its meshes to be spawned, empty otherwise
+	FText SpawnPendingText;
 };
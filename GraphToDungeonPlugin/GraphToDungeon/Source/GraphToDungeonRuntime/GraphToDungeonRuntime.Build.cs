@@ -0,0 +1,44 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+using System.IO;
+using UnrealBuildTool;
+
+public class GraphToDungeonRuntime : ModuleRules
+{
+	public GraphToDungeonRuntime(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicIncludePaths.AddRange(
+			new string[] {
+				Path.Combine(ModuleDirectory, "Public", "Graph"),
+			}
+			);
+
+
+		PrivateIncludePaths.AddRange(
+			new string[] {
+				"GraphToDungeonRuntime/Private",
+				"GraphToDungeonRuntime/Private/Graph",
+			}
+			);
+
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"GenericGraphRuntime",
+			}
+			);
+
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+			}
+			);
+	}
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief A* node storage for corridor search, nodes live in one flat array
+ * and the open list is an indexed binary heap supporting decrease-key.
+ * All buffers are kept between searches, Reset only empties them
+ */
+class FCorridorSearch
+{
+public:
+	struct FNode
+	{
+		FIntVector2 Position;
+		// Index of the node this one was reached from, INDEX_NONE for the search source
+		int32 Parent = INDEX_NONE;
+		uint32 F = 0;
+		uint32 G = 0;
+		// Position inside open list heap, INDEX_NONE when not open
+		int32 HeapIndex = INDEX_NONE;
+	};
+
+	/**
+	 * @brief Prepares for a new search while keeping allocated memory
+	 */
+	void Reset()
+	{
+		Nodes.Reset();
+		NodeIndices.Reset();
+		Heap.Reset();
+	}
+
+	/**
+	 * @brief Finds node at position or creates a new one
+	 * @param Position Node position
+	 * @param bOutAdded Set to true when the node was created by this call
+	 * @return Index of the node
+	 */
+	int32 FindOrAddNode(const FIntVector2 Position, bool& bOutAdded)
+	{
+		if (const int32* Index = NodeIndices.Find(Position))
+		{
+			bOutAdded = false;
+			return *Index;
+		}
+		bOutAdded = true;
+		const int32 Index = Nodes.AddDefaulted();
+		Nodes[Index].Position = Position;
+		NodeIndices.Add(Position, Index);
+		return Index;
+	}
+
+	FNode& GetNode(const int32 Index) { return Nodes[Index]; }
+	const FNode& GetNode(const int32 Index) const { return Nodes[Index]; }
+
+	bool IsOpenEmpty() const { return Heap.Num() == 0; }
+	bool IsOpen(const int32 Index) const { return Nodes[Index].HeapIndex != INDEX_NONE; }
+
+	/**
+	 * @brief Inserts node into the open list, or repositions it when it is already open
+	 * @param Index Node index with updated F
+	 */
+	void Open(const int32 Index)
+	{
+		if (Nodes[Index].HeapIndex == INDEX_NONE)
+		{
+			Nodes[Index].HeapIndex = Heap.Add(Index);
+		}
+		SiftUp(Nodes[Index].HeapIndex);
+	}
+
+	/**
+	 * @brief Removes node with the smallest F from the open list
+	 * @return Index of the removed node
+	 */
+	int32 PopOpen()
+	{
+		const int32 Top = Heap[0];
+		const int32 LastIndex = Heap.Pop(false);
+		Nodes[Top].HeapIndex = INDEX_NONE;
+		if (Heap.Num() > 0)
+		{
+			Heap[0] = LastIndex;
+			Nodes[LastIndex].HeapIndex = 0;
+			SiftDown(0);
+		}
+		return Top;
+	}
+
+	/**
+	 * @brief Peeks node with the smallest F
+	 */
+	int32 TopOpen() const { return Heap[0]; }
+
+private:
+	// Orders by F, ties are broken by position to keep the search deterministic
+	bool Less(const int32 A, const int32 B) const
+	{
+		const FNode& NodeA = Nodes[A];
+		const FNode& NodeB = Nodes[B];
+		if (NodeA.F != NodeB.F) return NodeA.F < NodeB.F;
+		if (NodeA.Position.X != NodeB.Position.X) return NodeA.Position.X < NodeB.Position.X;
+		return NodeA.Position.Y < NodeB.Position.Y;
+	}
+
+	void Place(const int32 HeapIndex, const int32 NodeIndex)
+	{
+		Heap[HeapIndex] = NodeIndex;
+		Nodes[NodeIndex].HeapIndex = HeapIndex;
+	}
+
+	void SiftUp(int32 HeapIndex)
+	{
+		const int32 NodeIndex = Heap[HeapIndex];
+		while (HeapIndex > 0)
+		{
+			const int32 ParentHeapIndex = (HeapIndex - 1) / 2;
+			if (!Less(NodeIndex, Heap[ParentHeapIndex])) break;
+			Place(HeapIndex, Heap[ParentHeapIndex]);
+			HeapIndex = ParentHeapIndex;
+		}
+		Place(HeapIndex, NodeIndex);
+	}
+
+	void SiftDown(int32 HeapIndex)
+	{
+		const int32 NodeIndex = Heap[HeapIndex];
+		const int32 Count = Heap.Num();
+		while (true)
+		{
+			int32 ChildHeapIndex = HeapIndex * 2 + 1;
+			if (ChildHeapIndex >= Count) break;
+			if (ChildHeapIndex + 1 < Count && Less(Heap[ChildHeapIndex + 1], Heap[ChildHeapIndex])) ChildHeapIndex++;
+			if (!Less(Heap[ChildHeapIndex], NodeIndex)) break;
+			Place(HeapIndex, Heap[ChildHeapIndex]);
+			HeapIndex = ChildHeapIndex;
+		}
+		Place(HeapIndex, NodeIndex);
+	}
+
+	TArray<FNode> Nodes;
+	TMap<FIntVector2, int32> NodeIndices;
+	TArray<int32> Heap;
+};
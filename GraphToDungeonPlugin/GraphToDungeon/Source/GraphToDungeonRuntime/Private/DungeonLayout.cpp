@@ -0,0 +1,192 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+
+#include "DungeonLayout.h"
+#include "DungeonLayoutGenerator.h"
+#include "LevelGraphSession.h"
+#include "LevelGraphNode.h"
+#include "LevelGraphEdge.h"
+#include "GraphToDungeonProperties.h"
+#include "UObject/SoftObjectPath.h"
+
+void FDungeonLayout::Empty()
+{
+	Seed = 0;
+	Rooms.Empty();
+	Corridors.Empty();
+	Tiles.Empty();
+}
+
+bool FDungeonLayout::Serialize(FArchive& Ar)
+{
+	// Counts read from disk are trusted only if the rest of the archive can hold that many elements,
+	// so a corrupted entry never asserts or allocates without bound
+	auto SerializeCount = [&Ar](int32& Count, const int64 MinElementSize) -> bool
+		{
+			Ar << Count;
+			if (!Ar.IsLoading()) return true;
+			const int64 RemainingSize = Ar.TotalSize() - Ar.Tell();
+			if (!Ar.IsError() && Count >= 0 && Count * MinElementSize <= RemainingSize) return true;
+			Ar.SetError();
+			return false;
+		};
+
+	// Themes are written once into a table of asset paths, rooms, corridors and tiles refer to them by index
+	TArray<UGraphToDungeonTheme*> Themes;
+	if (Ar.IsSaving())
+	{
+		for (const FDungeonLayoutRoom& Room : Rooms) Themes.AddUnique(Room.Theme);
+		for (const FDungeonLayoutCorridor& Corridor : Corridors) Themes.AddUnique(Corridor.Theme);
+		for (const FDungeonTile& Tile : Tiles) Themes.AddUnique(Tile.Theme);
+	}
+	int32 ThemeCount = Themes.Num();
+	if (!SerializeCount(ThemeCount, sizeof(int32))) return false;
+	if (Ar.IsLoading()) Themes.SetNum(ThemeCount);
+	bool bThemesResolved = true;
+	for (UGraphToDungeonTheme*& Theme : Themes)
+	{
+		FString ThemePath = Theme ? Theme->GetPathName() : FString();
+		Ar << ThemePath;
+		if (!Ar.IsLoading() || ThemePath.IsEmpty()) continue;
+		Theme = Cast<UGraphToDungeonTheme>(FSoftObjectPath(ThemePath).TryLoad());
+		bThemesResolved &= Theme != nullptr;
+	}
+	if (!bThemesResolved || Ar.IsError()) return false;
+	auto SerializeTheme = [&](UGraphToDungeonTheme*& Theme)
+		{
+			int32 ThemeIndex = Themes.IndexOfByKey(Theme);
+			Ar << ThemeIndex;
+			if (!Ar.IsLoading()) return;
+			if (!Themes.IsValidIndex(ThemeIndex)) Ar.SetError();
+			Theme = Themes.IsValidIndex(ThemeIndex) ? Themes[ThemeIndex] : nullptr;
+		};
+	auto SerializeCoords = [&Ar](FIntVector2& Coords) { Ar << Coords.X << Coords.Y; };
+
+	Ar << Seed;
+	int32 RoomCount = Rooms.Num();
+	if (!SerializeCount(RoomCount, 32)) return false;
+	if (Ar.IsLoading()) Rooms.SetNum(RoomCount);
+	for (FDungeonLayoutRoom& Room : Rooms)
+	{
+		SerializeCoords(Room.Origin);
+		Ar << Room.Width << Room.Height;
+		int32 DoorCount = Room.Doors.Num();
+		if (!SerializeCount(DoorCount, 16)) return false;
+		if (Ar.IsLoading()) Room.Doors.SetNum(DoorCount);
+		for (TTuple<FIntVector2, FIntVector2>& Door : Room.Doors)
+		{
+			SerializeCoords(Door.Key);
+			SerializeCoords(Door.Value);
+		}
+		SerializeTheme(Room.Theme);
+		Ar << Room.FirstTile << Room.TileCount;
+	}
+	int32 CorridorCount = Corridors.Num();
+	if (!SerializeCount(CorridorCount, 20)) return false;
+	if (Ar.IsLoading()) Corridors.SetNum(CorridorCount);
+	for (FDungeonLayoutCorridor& Corridor : Corridors)
+	{
+		int32 TileCount = Corridor.Tiles.Num();
+		if (!SerializeCount(TileCount, 8)) return false;
+		if (Ar.IsLoading()) Corridor.Tiles.SetNum(TileCount);
+		for (FIntVector2& Tile : Corridor.Tiles) SerializeCoords(Tile);
+		Ar << Corridor.Width;
+		SerializeTheme(Corridor.Theme);
+		Ar << Corridor.FirstTile << Corridor.TileCount;
+	}
+	int32 TileCount = Tiles.Num();
+	if (!SerializeCount(TileCount, 17)) return false;
+	if (Ar.IsLoading()) Tiles.SetNum(TileCount);
+	for (FDungeonTile& Tile : Tiles)
+	{
+		SerializeCoords(Tile.Position);
+		uint8 Type = (uint8)Tile.Type;
+		Ar << Type << Tile.Yaw;
+		if (Ar.IsLoading() && Type > (uint8)EDungeonTileType::CorridorWallInsideCorner) Ar.SetError();
+		Tile.Type = (EDungeonTileType)Type;
+		SerializeTheme(Tile.Theme);
+	}
+	if (Ar.IsError()) return false;
+	if (!Ar.IsLoading()) return true;
+
+	// Spawning indexes tiles by these ranges
+	auto IsTileRangeValid = [this](const int32 FirstTile, const int32 RangeCount)
+		{
+			return FirstTile >= 0 && RangeCount >= 0 && (int64)FirstTile + RangeCount <= Tiles.Num();
+		};
+	for (const FDungeonLayoutRoom& Room : Rooms)
+	{
+		if (!IsTileRangeValid(Room.FirstTile, Room.TileCount)) return false;
+	}
+	for (const FDungeonLayoutCorridor& Corridor : Corridors)
+	{
+		if (!IsTileRangeValid(Corridor.FirstTile, Corridor.TileCount)) return false;
+	}
+	return true;
+}
+
+FDungeonLayoutInput FDungeonLayoutInput::Make(const ULevelGraphSession* LevelGraph, const UGraphToDungeonProperties* LevelProperties)
+{
+	FDungeonLayoutInput Input;
+	Input.MaxCorridorLength = LevelProperties->MaxCorridorLength;
+	Input.MaxBacktrackingSteps = LevelProperties->MaxBacktrackingSteps;
+	if (!LevelGraph) return Input;
+
+	TMap<const UGenericGraphNode*, int32> NodeIndices;
+	for (int32 NodeIndex = 0; NodeIndex < LevelGraph->AllNodes.Num(); NodeIndex++)
+	{
+		NodeIndices.Add(LevelGraph->AllNodes[NodeIndex], NodeIndex);
+	}
+	// Edge between two nodes is shared by both of them
+	TMap<const UGenericGraphEdge*, int32> EdgeIndices;
+	Input.Nodes.SetNum(LevelGraph->AllNodes.Num());
+	for (int32 NodeIndex = 0; NodeIndex < LevelGraph->AllNodes.Num(); NodeIndex++)
+	{
+		UGenericGraphNode* GenericNode = LevelGraph->AllNodes[NodeIndex];
+		// Nodes and edges of other classes get the default room and corridor properties
+		const ULevelGraphNode* Node = Cast<ULevelGraphNode>(GenericNode);
+		if (!Node) Node = GetDefault<ULevelGraphNode>();
+		FNode& InputNode = Input.Nodes[NodeIndex];
+		InputNode.Width = Node->Width;
+		InputNode.Height = Node->Height;
+		InputNode.RoomTheme = Node->RoomTheme;
+
+		TArray<UGenericGraphNode*, TInlineAllocator<8>> NeighbourNodes;
+		NeighbourNodes.Append(GenericNode->ChildrenNodes);
+		NeighbourNodes.Append(GenericNode->ParentNodes);
+		for (UGenericGraphNode* NeighbourNode : NeighbourNodes)
+		{
+			const int32* NeighbourIndex = NodeIndices.Find(NeighbourNode);
+			if (!NeighbourIndex) continue;
+			const UGenericGraphEdge* GenericEdge = GenericNode->GetEdge(NeighbourNode);
+			if (!GenericEdge) GenericEdge = NeighbourNode->GetEdge(GenericNode);
+			const int32* EdgeIndex = EdgeIndices.Find(GenericEdge);
+			if (!EdgeIndex)
+			{
+				const ULevelGraphEdge* Edge = Cast<ULevelGraphEdge>(GenericEdge);
+				if (!Edge) Edge = GetDefault<ULevelGraphEdge>();
+				FEdge& InputEdge = Input.Edges.AddDefaulted_GetRef();
+				InputEdge.Width = Edge->Width;
+				InputEdge.CorridorTheme = Edge->CorridorTheme;
+				EdgeIndex = &EdgeIndices.Add(GenericEdge, Input.Edges.Num() - 1);
+			}
+			InputNode.Neighbours.Add({ *NeighbourIndex, *EdgeIndex });
+		}
+	}
+	return Input;
+}
+
+bool FDungeonLayout::Generate(const FDungeonLayoutInput& Input, const int32 Seed, FDungeonLayout& OutLayout,
+	FDungeonLayoutProgress* Progress)
+{
+	FDungeonLayoutGenerator LayoutGenerator;
+	if (!LayoutGenerator.Generate(Input, Seed, Progress)) return false;
+	LayoutGenerator.BuildLayout(OutLayout);
+	return true;
+}
+
+bool FDungeonLayout::Generate(const ULevelGraphSession* LevelGraph, const UGraphToDungeonProperties* LevelProperties,
+	const int32 Seed, FDungeonLayout& OutLayout, FDungeonLayoutProgress* Progress)
+{
+	return Generate(FDungeonLayoutInput::Make(LevelGraph, LevelProperties), Seed, OutLayout, Progress);
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+
+#include "DungeonLayoutCache.h"
+#include "DungeonLayout.h"
+#include "Hash/xxhash.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// Marks cache entry files
+	constexpr uint32 EntryMagic = 0x4C443247;
+}
+
+uint64 FDungeonLayoutCache::HashInputs(const FDungeonLayoutInput& Input)
+{
+	FXxHash64Builder Builder;
+	auto UpdateInt = [&Builder](const int32 Value) { Builder.Update(&Value, sizeof(Value)); };
+	auto UpdateObject = [&Builder](const UObject* Object)
+		{
+			const FString Path = Object ? Object->GetPathName() : FString();
+			const int32 Length = Path.Len();
+			Builder.Update(&Length, sizeof(Length));
+			Builder.Update(*Path, Length * sizeof(TCHAR));
+		};
+
+	UpdateInt(Version);
+	UpdateInt(Input.MaxCorridorLength);
+	UpdateInt(Input.MaxBacktrackingSteps);
+
+	// Neighbour order matters because it decides the placement order
+	UpdateInt(Input.Nodes.Num());
+	for (const FDungeonLayoutInput::FNode& Node : Input.Nodes)
+	{
+		UpdateInt(Node.Width);
+		UpdateInt(Node.Height);
+		UpdateObject(Node.RoomTheme);
+		UpdateInt(Node.Neighbours.Num());
+		for (const FDungeonLayoutInput::FNeighbour& Neighbour : Node.Neighbours)
+		{
+			UpdateInt(Neighbour.Node);
+			UpdateInt(Neighbour.Edge);
+		}
+	}
+	UpdateInt(Input.Edges.Num());
+	for (const FDungeonLayoutInput::FEdge& Edge : Input.Edges)
+	{
+		UpdateInt(Edge.Width);
+		UpdateObject(Edge.CorridorTheme);
+	}
+	return Builder.Finalize().Hash;
+}
+
+FDungeonLayoutCache::EEntry FDungeonLayoutCache::Find(const uint64 InputHash, const int32 Seed, FDungeonLayout& OutLayout)
+{
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*GetEntryPath(InputHash, Seed), FILEREAD_Silent));
+	if (!Reader) return EEntry::Missing;
+	uint32 Magic = 0;
+	int32 EntryVersion = 0;
+	bool bSuccess = false;
+	*Reader << Magic << EntryVersion << bSuccess;
+	if (Reader->IsError() || Magic != EntryMagic || EntryVersion != Version) return EEntry::Missing;
+	if (!bSuccess) return EEntry::Failure;
+	// Unresolved theme, truncated or corrupted file, the seed is generated again
+	if (!OutLayout.Serialize(*Reader) || Reader->IsError()) return EEntry::Missing;
+	return EEntry::Success;
+}
+
+void FDungeonLayoutCache::Store(const uint64 InputHash, const int32 Seed, FDungeonLayout* Layout)
+{
+	const FString Path = GetEntryPath(InputHash, Seed);
+	// Written aside and moved into place, so readers never see partial entries
+	const FString TempPath = Path + TEXT(".tmp");
+	{
+		TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempPath));
+		if (!Writer) return;
+		uint32 Magic = EntryMagic;
+		int32 EntryVersion = Version;
+		bool bSuccess = Layout != nullptr;
+		*Writer << Magic << EntryVersion << bSuccess;
+		if (Layout) Layout->Serialize(*Writer);
+		if (!Writer->Close()) return;
+	}
+	IFileManager::Get().Move(*Path, *TempPath, true, true, false, true);
+	Prune();
+}
+
+void FDungeonLayoutCache::Prune()
+{
+	struct FEntryFile
+	{
+		FString Path;
+		FDateTime ModificationTime;
+	};
+	TArray<FEntryFile> Entries;
+	IFileManager::Get().IterateDirectoryStat(*GetDirectory(), [&Entries](const TCHAR* Path, const FFileStatData& StatData)
+		{
+			if (!StatData.bIsDirectory && FPaths::GetExtension(Path) == TEXT("layout")) Entries.Add({ Path, StatData.ModificationTime });
+			return true;
+		});
+	if (Entries.Num() <= MaxEntries) return;
+	// Entries of older versions are never rewritten, so they are the first to go
+	Entries.Sort([](const FEntryFile& A, const FEntryFile& B) { return A.ModificationTime < B.ModificationTime; });
+	for (int32 Index = 0; Index < Entries.Num() - MaxEntries; Index++)
+	{
+		IFileManager::Get().Delete(*Entries[Index].Path, false, false, true);
+	}
+}
+
+FString FDungeonLayoutCache::GetDirectory()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("GraphToDungeon"), TEXT("LayoutCache"));
+}
+
+FString FDungeonLayoutCache::GetEntryPath(const uint64 InputHash, const int32 Seed)
+{
+	return FPaths::Combine(GetDirectory(), FString::Printf(TEXT("%016llx_%d.layout"), InputHash, Seed));
+}
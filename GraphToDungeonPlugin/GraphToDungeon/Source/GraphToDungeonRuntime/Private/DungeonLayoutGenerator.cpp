@@ -0,0 +1,1273 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+
+#include "DungeonLayoutGenerator.h"
+#include "DerivedSeed.h"
+#include "Containers/Queue.h"
+#include <array>
+
+FDungeonLayoutGenerator::~FDungeonLayoutGenerator()
+{
+	ReleaseRooms();
+}
+
+void FDungeonLayoutGenerator::ReleaseRooms()
+{
+	// Rooms live in the arena, only their destructors run here and the memory is returned all at once
+	for (URoom* Room : AllRooms)
+	{
+		Room->~URoom();
+	}
+	AllRooms.Reset();
+	Arena.Flush();
+}
+
+void FDungeonLayoutGenerator::InsertOccupiedTiles(URoom* Room)
+{
+	// Only room walls are occupied
+	OccupiedTiles.AddRect(Room->Origin, Room->Width, 1);
+	OccupiedTiles.AddRect(Room->Origin + FIntVector2(0, Room->Height - 1), Room->Width, 1);
+	OccupiedTiles.AddRect(Room->Origin, 1, Room->Height);
+	OccupiedTiles.AddRect(Room->Origin + FIntVector2(Room->Width - 1, 0), 1, Room->Height);
+};
+
+bool FDungeonLayoutGenerator::IsOccupied(const FIntVector2 Coords, const int32 Width, const int32 Height)
+{
+	return OccupiedTiles.IsRectOccupied(Coords, Width, Height);
+}
+
+int32 FDungeonLayoutGenerator::SegmentLength(const TTuple<FIntVector2, FIntVector2> Segment)
+{
+	return FMath::Abs(
+		Segment.Key.X - Segment.Value.X +
+		Segment.Key.Y - Segment.Value.Y);
+};
+
+bool FDungeonLayoutGenerator::FindRoomOrigin(const URoom* ParentRoom, const EDirection Direction, const int32 MinDistance,
+	const int32 Width, const int32 Height, FIntVector2& OutOrigin)
+{
+	const bool bAlongX = Direction == EDirection::DOWN || Direction == EDirection::UP;
+	for (int32 Distance = MinDistance; Distance < MinDistance + MaxPlacementRings; Distance++)
+	{
+		// Ring is a line of origins at the same distance from the parent side, widening with the distance
+		int32 Fixed(0);
+		switch (Direction)
+		{
+		case EDirection::DOWN:
+			Fixed = ParentRoom->Origin.Y - Distance;
+			break;
+		case EDirection::RIGHT:
+			Fixed = ParentRoom->Origin.X + ParentRoom->Width - 1 + Distance;
+			break;
+		case EDirection::UP:
+			Fixed = ParentRoom->Origin.Y + ParentRoom->Height - 1 + Distance;
+			break;
+		case EDirection::LEFT:
+			Fixed = ParentRoom->Origin.X - Distance;
+			break;
+		}
+		const int32 From = bAlongX ? ParentRoom->Origin.X - Distance : ParentRoom->Origin.Y - Distance;
+		const int32 To = bAlongX ?
+			ParentRoom->Origin.X + ParentRoom->Width - 2 + Distance :
+			ParentRoom->Origin.Y + ParentRoom->Height - 2 + Distance;
+		OriginCandidates.Reset();
+		for (int32 Along = From; Along <= To; Along++)
+		{
+			const FIntVector2 Origin = bAlongX ? FIntVector2(Along, Fixed) : FIntVector2(Fixed, Along);
+			if (!IsOccupied(Origin, Width, Height)) OriginCandidates.Add(Origin);
+		}
+		if (OriginCandidates.Num() == 0) continue;
+		OutOrigin = OriginCandidates[RandomStream.RandHelper(OriginCandidates.Num())];
+		return true;
+	}
+	return false;
+}
+
+FDungeonLayoutGenerator::URoom* FDungeonLayoutGenerator::ConnectWithNew(URoom* ParentRoom, const FDungeonLayoutInput::FNode& ChildRoomNode,
+	const FDungeonLayoutInput::FEdge& Edge)
+{
+	const int32 EdgeWidth = Edge.Width;
+	// Create new room object
+	URoom* NewRoom = AddRoom();
+	NewRoom->Width = ChildRoomNode.Width;
+	NewRoom->Height = ChildRoomNode.Height;
+	NewRoom->LocalTheme = ChildRoomNode.RoomTheme;
+
+	bool bIsCorridorPossible(false);
+	int32 GenerationRetries(0);
+	// Minimum distance the new room origin can be from the parent room
+	int32 MinDistanceFromParent(0);
+	TTuple<FIntVector2, FIntVector2> ParentRoomDoorSegment(FIntVector2(0, 0), FIntVector2(0, 0));
+	TTuple<FIntVector2, FIntVector2> NewRoomDoorSegment(FIntVector2(0, 0), FIntVector2(0, 0));
+	int32 ParentRoomDoorSegmentLength(0);
+	int32 NewRoomDoorSegmentLength(0);
+	int32 ParentRoomDoorStartCoord(0);
+	int32 NewRoomDoorStartCoord(0);
+	TTuple<FIntVector2, FIntVector2> ParentRoomDoor(FIntVector2(0, 0), FIntVector2(0, 0));
+	TTuple<FIntVector2, FIntVector2> NewRoomDoor(FIntVector2(0, 0), FIntVector2(0, 0));
+	// Corridor found by the last successful search, committed once the room is placed
+	UCorridor Corridor;
+	while (!bIsCorridorPossible && GenerationRetries < 10)
+	{
+		//UE_LOG(LogTemp, Warning, TEXT("Whole retry %d"), GenerationRetries);
+		GenerationRetries++;
+		auto ShuffleIndices = [&](TArray<int32, TInlineAllocator<4>>& Array) -> void
+			{
+				const int32 ArraySize = Array.Num();
+				for (int32 i = 0; i < ArraySize; ++i)
+				{
+					const int32 RandomIndex = RandomStream.RandRange(i, ArraySize - 1);
+					Array.Swap(i, RandomIndex);
+				}
+			};
+		// Create random order of segments
+		TArray<int32, TInlineAllocator<4>> SegmentIndices{ 0, 1, 2, 3 };
+		ShuffleIndices(SegmentIndices);
+		int32 SegmentIndexCounter(0);
+		// Find next non used segment
+		while (ParentRoom->Segments[SegmentIndices[SegmentIndexCounter]].bIsUsed &&
+			SegmentIndexCounter < 3) SegmentIndexCounter++;
+		// Parent room segment to use
+		URoomSegment& ParentRoomSegment = ParentRoom->Segments[SegmentIndices[SegmentIndexCounter]];
+		// Create new room based on segment type
+		switch (ParentRoomSegment.Direction)
+		{
+		case EDirection::DOWN:
+			MinDistanceFromParent = NewRoom->Height + EdgeWidth + 1;
+			if (!FindRoomOrigin(ParentRoom, EDirection::DOWN, MinDistanceFromParent, NewRoom->Width, NewRoom->Height, NewRoom->Origin)) continue;
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(1, 0), ParentRoom->Origin + FIntVector2(ParentRoom->Width - 2, 0));
+			NewRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(NewRoom->Origin + FIntVector2(1, NewRoom->Height - 1), NewRoom->Origin + FIntVector2(NewRoom->Width - 2, NewRoom->Height - 1));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			NewRoomDoorSegmentLength = SegmentLength(NewRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			NewRoomDoorStartCoord = RandomStream.RandRange(0, NewRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord, ParentRoomDoorSegment.Key.Y),
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord + EdgeWidth - 1, ParentRoomDoorSegment.Key.Y));
+			NewRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(NewRoomDoorSegment.Key.X + NewRoomDoorStartCoord, NewRoomDoorSegment.Key.Y),
+				FIntVector2(NewRoomDoorSegment.Key.X + NewRoomDoorStartCoord + EdgeWidth - 1, NewRoomDoorSegment.Key.Y));
+			bIsCorridorPossible = FindAWay(
+				ParentRoomDoor, NewRoomDoor,
+				ParentRoom, NewRoom, Corridor, NewRoom);
+			if (!bIsCorridorPossible) continue;
+			NewRoom->UpSegment().bIsUsed = true;
+			NewRoom->UpSegment().Door = NewRoomDoor;
+			break;
+		case EDirection::RIGHT:
+			MinDistanceFromParent = EdgeWidth + 1;
+			if (!FindRoomOrigin(ParentRoom, EDirection::RIGHT, MinDistanceFromParent, NewRoom->Width, NewRoom->Height, NewRoom->Origin)) continue;
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(ParentRoom->Width - 1, 1), ParentRoom->Origin + FIntVector2(ParentRoom->Width - 1, ParentRoom->Height - 2));
+			NewRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(NewRoom->Origin + FIntVector2(0, 1), NewRoom->Origin + FIntVector2(0, NewRoom->Height - 2));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			NewRoomDoorSegmentLength = SegmentLength(NewRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			NewRoomDoorStartCoord = RandomStream.RandRange(0, NewRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord),
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord + EdgeWidth - 1));
+			NewRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(NewRoomDoorSegment.Key.X, NewRoomDoorSegment.Key.Y + NewRoomDoorStartCoord),
+				FIntVector2(NewRoomDoorSegment.Key.X, NewRoomDoorSegment.Key.Y + NewRoomDoorStartCoord + EdgeWidth - 1));
+			bIsCorridorPossible = FindAWay(
+				ParentRoomDoor, NewRoomDoor,
+				ParentRoom, NewRoom, Corridor, NewRoom);
+			if (!bIsCorridorPossible) continue;
+			NewRoom->LeftSegment().bIsUsed = true;
+			NewRoom->UpSegment().Door = NewRoomDoor;
+			break;
+		case EDirection::UP:
+			MinDistanceFromParent = EdgeWidth + 1;
+			if (!FindRoomOrigin(ParentRoom, EDirection::UP, MinDistanceFromParent, NewRoom->Width, NewRoom->Height, NewRoom->Origin)) continue;
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(1, ParentRoom->Height - 1), ParentRoom->Origin + FIntVector2(ParentRoom->Width - 2, ParentRoom->Height - 1));;
+			NewRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(NewRoom->Origin + FIntVector2(1, 0), NewRoom->Origin + FIntVector2(NewRoom->Width - 2, 0));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			NewRoomDoorSegmentLength = SegmentLength(NewRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			NewRoomDoorStartCoord = RandomStream.RandRange(0, NewRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord, ParentRoomDoorSegment.Key.Y),
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord + EdgeWidth - 1, ParentRoomDoorSegment.Key.Y));
+			NewRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(NewRoomDoorSegment.Key.X + NewRoomDoorStartCoord, NewRoomDoorSegment.Key.Y),
+				FIntVector2(NewRoomDoorSegment.Key.X + NewRoomDoorStartCoord + EdgeWidth - 1, NewRoomDoorSegment.Key.Y));
+			bIsCorridorPossible = FindAWay(
+				ParentRoomDoor, NewRoomDoor,
+				ParentRoom, NewRoom, Corridor, NewRoom);
+			if (!bIsCorridorPossible) continue;
+			NewRoom->DownSegment().bIsUsed = true;
+			NewRoom->UpSegment().Door = NewRoomDoor;
+			break;
+		case EDirection::LEFT:
+			MinDistanceFromParent = NewRoom->Width + EdgeWidth + 1;
+			if (!FindRoomOrigin(ParentRoom, EDirection::LEFT, MinDistanceFromParent, NewRoom->Width, NewRoom->Height, NewRoom->Origin)) continue;
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(0, 1), ParentRoom->Origin + FIntVector2(0, ParentRoom->Height - 2));
+			NewRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(NewRoom->Origin + FIntVector2(NewRoom->Width - 1, 1), NewRoom->Origin + FIntVector2(NewRoom->Width - 1, NewRoom->Height - 2));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			NewRoomDoorSegmentLength = SegmentLength(NewRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			NewRoomDoorStartCoord = RandomStream.RandRange(0, NewRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord),
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord + EdgeWidth - 1));
+			NewRoomDoor = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(NewRoomDoorSegment.Key.X, NewRoomDoorSegment.Key.Y + NewRoomDoorStartCoord),
+				FIntVector2(NewRoomDoorSegment.Key.X, NewRoomDoorSegment.Key.Y + NewRoomDoorStartCoord + EdgeWidth - 1));
+			bIsCorridorPossible = FindAWay(
+				ParentRoomDoor, NewRoomDoor,
+				ParentRoom, NewRoom, Corridor, NewRoom);
+			if (!bIsCorridorPossible) continue;
+			NewRoom->RightSegment().bIsUsed = true;
+			NewRoom->UpSegment().Door = NewRoomDoor;
+			break;
+		}
+		if (bIsCorridorPossible)
+		{
+			UseSegment(ParentRoom, ParentRoomSegment, ParentRoomDoor);
+			NewRoom->Doors.Add(NewRoom->UpSegment().Door);
+			InsertOccupiedTiles(NewRoom);
+			CommitCorridor(Corridor, Edge);
+		}
+	}
+	if (!bIsCorridorPossible) InvalidSeed = true;
+	return NewRoom;
+};
+
+bool FDungeonLayoutGenerator::ConnectWithExisting(URoom* ParentRoom, URoom* ChildRoom, const FDungeonLayoutInput::FEdge& Edge)
+{
+	const int32 EdgeWidth = Edge.Width;
+	URoom MirrorParentRoom;
+	MirrorParentRoom.Width = ParentRoom->Width;
+	MirrorParentRoom.Height = ParentRoom->Height;
+	MirrorParentRoom.Origin = ParentRoom->Origin;
+	MirrorParentRoom.Segments = ParentRoom->Segments;
+	URoom MirrorChildRoom;
+	MirrorChildRoom.Width = ChildRoom->Width;
+	MirrorChildRoom.Height = ChildRoom->Height;
+	MirrorChildRoom.Origin = ChildRoom->Origin;
+	MirrorChildRoom.Segments = ChildRoom->Segments;
+	// Candidate doors with directions of their segments
+	TArray<TTuple<FIntVector2, FIntVector2>, TInlineAllocator<4>> ParentDoors;
+	TArray<EDirection, TInlineAllocator<4>> ParentDoorDirections;
+	TArray<TTuple<FIntVector2, FIntVector2>, TInlineAllocator<4>> ChildDoors;
+	TArray<EDirection, TInlineAllocator<4>> ChildDoorDirections;
+	// Generate door for mirror parent room segment
+	for (auto& ParentRoomSegment : MirrorParentRoom.Segments)
+	{
+		//if (ParentRoomSegment.bIsUsed) continue;
+		//
+		TTuple<FIntVector2, FIntVector2> ParentRoomDoorSegment(FIntVector2(0, 0), FIntVector2(0, 0));
+		int32 ParentRoomDoorSegmentLength(0);
+		int32 ParentRoomDoorStartCoord(0);
+		switch (ParentRoomSegment.Direction)
+		{
+		case EDirection::DOWN:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(1, 0), ParentRoom->Origin + FIntVector2(ParentRoom->Width - 2, 0));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord, ParentRoomDoorSegment.Key.Y),
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord + EdgeWidth - 1, ParentRoomDoorSegment.Key.Y));
+			break;
+		case EDirection::RIGHT:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(ParentRoom->Width - 1, 1), ParentRoom->Origin + FIntVector2(ParentRoom->Width - 1, ParentRoom->Height - 2));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord),
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord + EdgeWidth - 1));
+			break;
+		case EDirection::UP:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(1, ParentRoom->Height - 1), ParentRoom->Origin + FIntVector2(ParentRoom->Width - 2, ParentRoom->Height - 1));;
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord, ParentRoomDoorSegment.Key.Y),
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord + EdgeWidth - 1, ParentRoomDoorSegment.Key.Y));
+			break;
+		case EDirection::LEFT:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ParentRoom->Origin + FIntVector2(0, 1), ParentRoom->Origin + FIntVector2(0, ParentRoom->Height - 2));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ParentRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord),
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord + EdgeWidth - 1));
+			break;
+		}
+		ParentDoors.Add(ParentRoomSegment.Door);
+		ParentDoorDirections.Add(ParentRoomSegment.Direction);
+		//
+	}
+	// Generate door for mirror child room segment
+	for (auto& ChildRoomSegment : MirrorChildRoom.Segments)
+	{
+		if (ChildRoomSegment.bIsUsed) continue;
+		//
+		TTuple<FIntVector2, FIntVector2> ParentRoomDoorSegment(FIntVector2(0, 0), FIntVector2(0, 0));
+		int32 ParentRoomDoorSegmentLength(0);
+		int32 ParentRoomDoorStartCoord(0);
+		switch (ChildRoomSegment.Direction)
+		{
+		case EDirection::DOWN:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ChildRoom->Origin, ChildRoom->Origin + FIntVector2(ChildRoom->Width - 1, 0));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ChildRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord, ParentRoomDoorSegment.Key.Y),
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord + EdgeWidth - 1, ParentRoomDoorSegment.Key.Y));
+			break;
+		case EDirection::RIGHT:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ChildRoom->Origin + FIntVector2(ChildRoom->Width - 1, 0), ChildRoom->Origin + FIntVector2(ChildRoom->Width - 1, ChildRoom->Height - 1));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ChildRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord),
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord + EdgeWidth - 1));
+			break;
+		case EDirection::UP:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ChildRoom->Origin + FIntVector2(0, ChildRoom->Height - 1), ChildRoom->Origin + FIntVector2(ChildRoom->Width - 1, ChildRoom->Height - 1));;
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ChildRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord, ParentRoomDoorSegment.Key.Y),
+				FIntVector2(ParentRoomDoorSegment.Key.X + ParentRoomDoorStartCoord + EdgeWidth - 1, ParentRoomDoorSegment.Key.Y));
+			break;
+		case EDirection::LEFT:
+			ParentRoomDoorSegment = TTuple<FIntVector2, FIntVector2>
+				(ChildRoom->Origin, ChildRoom->Origin + FIntVector2(0, ChildRoom->Height - 1));
+			ParentRoomDoorSegmentLength = SegmentLength(ParentRoomDoorSegment);
+			ParentRoomDoorStartCoord = RandomStream.RandRange(0, ParentRoomDoorSegmentLength - EdgeWidth);
+			ChildRoomSegment.Door = TTuple<FIntVector2, FIntVector2>(
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord),
+				FIntVector2(ParentRoomDoorSegment.Key.X, ParentRoomDoorSegment.Key.Y + ParentRoomDoorStartCoord + EdgeWidth - 1));
+			break;
+		}
+		ChildDoors.Add(ChildRoomSegment.Door);
+		ChildDoorDirections.Add(ChildRoomSegment.Direction);
+		//
+	}
+	// Single search from all parent doors to the closest reachable child door
+	int32 SourceIndex;
+	int32 FinishIndex;
+	if (ChildDoors.Num() == 0) return false;
+	UCorridor Corridor;
+	if (!FindAWay(ParentDoors, ChildDoors, ParentRoom, ChildRoom, Corridor, SourceIndex, FinishIndex)) return false;
+	const TTuple<FIntVector2, FIntVector2> SourceDoorPos = ParentDoors[SourceIndex];
+	const TTuple<FIntVector2, FIntVector2> FinishDoorPos = ChildDoors[FinishIndex];
+	const EDirection ParentSegment = ParentDoorDirections[SourceIndex];
+	const EDirection ChildSegment = ChildDoorDirections[FinishIndex];
+	// Create corridor
+	UseSegment(ParentRoom, ParentRoom->GetSegment(ParentSegment), SourceDoorPos);
+	UseSegment(ChildRoom, ChildRoom->GetSegment(ChildSegment), FinishDoorPos);
+	CommitCorridor(Corridor, Edge);
+	return true;
+}
+
+bool FDungeonLayoutGenerator::IsSquareBlocked(const FIntVector2 Origin, const int32 Size, const URoom* PendingRoom) const
+{
+	if (OccupiedTiles.IsSquareOccupied(Origin, Size)) return true;
+	if (!PendingRoom) return false;
+	// Square touches pending room walls when it overlaps the room but does not fit inside its interior
+	const bool bOverlapsRoom =
+		Origin.X < PendingRoom->Origin.X + PendingRoom->Width && Origin.X + Size > PendingRoom->Origin.X &&
+		Origin.Y < PendingRoom->Origin.Y + PendingRoom->Height && Origin.Y + Size > PendingRoom->Origin.Y;
+	const bool bInsideInterior =
+		Origin.X > PendingRoom->Origin.X && Origin.X + Size < PendingRoom->Origin.X + PendingRoom->Width &&
+		Origin.Y > PendingRoom->Origin.Y && Origin.Y + Size < PendingRoom->Origin.Y + PendingRoom->Height;
+	return bOverlapsRoom && !bInsideInterior;
+}
+
+void FDungeonLayoutGenerator::CommitCorridor(UCorridor& Corridor, const FDungeonLayoutInput::FEdge& Edge)
+{
+	Corridor.LocalTheme = Edge.CorridorTheme;
+	for (const auto& Square : Corridor.Squares)
+	{
+		OccupiedTiles.AddRect(Square, Corridor.Width, Corridor.Width);
+	}
+	for (const auto& Point : Corridor.Points)
+	{
+		OccupiedTiles.Add(Point);
+	}
+	AllCorridors.Add(MoveTemp(Corridor));
+	Journal.Add({ FJournalEntry::CorridorAdded });
+}
+
+bool FDungeonLayoutGenerator::FindAWay(
+	const TTuple<FIntVector2, FIntVector2>& Source,
+	const TTuple<FIntVector2, FIntVector2>& Finish,
+	const URoom* SourceRoom, const URoom* FinishRoom, UCorridor& OutCorridor, const URoom* PendingRoom)
+{
+	int32 SourceIndex;
+	int32 FinishIndex;
+	return FindAWay(MakeArrayView(&Source, 1), MakeArrayView(&Finish, 1), SourceRoom, FinishRoom, OutCorridor, SourceIndex, FinishIndex, PendingRoom);
+}
+
+bool FDungeonLayoutGenerator::FindAWay(
+	TArrayView<const TTuple<FIntVector2, FIntVector2>> Sources,
+	TArrayView<const TTuple<FIntVector2, FIntVector2>> Finishes,
+	const URoom* SourceRoom, const URoom* FinishRoom, UCorridor& OutCorridor,
+	int32& OutSourceIndex, int32& OutFinishIndex, const URoom* PendingRoom)
+{
+	OutSourceIndex = INDEX_NONE;
+	OutFinishIndex = INDEX_NONE;
+	const int32 Width = SegmentLength(Sources[0]) + 1;
+	OutCorridor = UCorridor();
+	UCorridor* Corridor = &OutCorridor;
+	Corridor->Width = Width;
+	Search.Reset();
+
+	// First corridor square in front of the source door and the two tiles adjoining the door
+	struct FCorridorStart
+	{
+		FIntVector2 Square;
+		FIntVector2 Bot;
+		FIntVector2 Top;
+	};
+	// Tile in front of the finish door, direction the door faces and the two tiles adjoining the door
+	struct FCorridorFinish
+	{
+		FIntVector2 Tile;
+		EDirection Direction;
+		FIntVector2 Bot;
+		FIntVector2 Top;
+	};
+	TArray<FCorridorStart, TInlineAllocator<4>> Starts;
+	for (const auto& Door : Sources)
+	{
+		FCorridorStart& Start = Starts.AddDefaulted_GetRef();
+		if (Door.Key.X == Door.Value.X)
+		{
+			if (Door.Key.X == SourceRoom->Origin.X)
+			{
+				Start.Square = FIntVector2(Door.Key.X - Width, Door.Key.Y);
+				Start.Bot = FIntVector2(Door.Key.X - 1, Door.Key.Y);
+				Start.Top = FIntVector2(Door.Key.X - 1, Door.Key.Y + Width - 1);
+			}
+			else
+			{
+				Start.Square = FIntVector2(Door.Key.X + 1, Door.Key.Y);
+				Start.Bot = FIntVector2(Door.Key.X + 1, Door.Key.Y);
+				Start.Top = FIntVector2(Door.Key.X + 1, Door.Key.Y + Width - 1);
+			}
+		}
+		else
+		{
+			if (Door.Key.Y == SourceRoom->Origin.Y)
+			{
+				Start.Square = FIntVector2(Door.Key.X, Door.Key.Y - Width);
+				Start.Bot = FIntVector2(Door.Key.X, Door.Key.Y - 1);
+				Start.Top = FIntVector2(Door.Key.X + Width - 1, Door.Key.Y - 1);
+			}
+			else
+			{
+				Start.Square = FIntVector2(Door.Key.X, Door.Key.Y + 1);
+				Start.Bot = FIntVector2(Door.Key.X, Door.Key.Y + 1);
+				Start.Top = FIntVector2(Door.Key.X + Width - 1, Door.Key.Y + 1);
+			}
+		}
+	}
+	TArray<FCorridorFinish, TInlineAllocator<4>> Ends;
+	for (const auto& Door : Finishes)
+	{
+		FCorridorFinish& End = Ends.AddDefaulted_GetRef();
+		if (Door.Key.X == Door.Value.X)
+		{
+			if (Door.Key.X == FinishRoom->Origin.X)
+			{
+				End.Tile = FIntVector2(Door.Key.X - 1, Door.Key.Y);
+				End.Direction = EDirection::LEFT;
+				End.Top = FIntVector2(Door.Key.X - 1, Door.Key.Y + Width - 1);
+			}
+			else
+			{
+				End.Tile = FIntVector2(Door.Key.X + 1, Door.Key.Y);
+				End.Direction = EDirection::RIGHT;
+				End.Top = FIntVector2(Door.Key.X + 1, Door.Key.Y + Width - 1);
+			}
+		}
+		else
+		{
+			if (Door.Key.Y == FinishRoom->Origin.Y)
+			{
+				End.Tile = FIntVector2(Door.Key.X, Door.Key.Y - 1);
+				End.Direction = EDirection::DOWN;
+				End.Top = FIntVector2(Door.Key.X + Width - 1, Door.Key.Y - 1);
+			}
+			else
+			{
+				End.Tile = FIntVector2(Door.Key.X, Door.Key.Y + 1);
+				End.Direction = EDirection::UP;
+				End.Top = FIntVector2(Door.Key.X + Width - 1, Door.Key.Y + 1);
+			}
+		}
+		End.Bot = End.Tile;
+	}
+
+	// All source doors are searched at once, every start square is a root of the search
+	for (const auto& Start : Starts)
+	{
+		bool bAdded;
+		const int32 StartIndex = Search.FindOrAddNode(Start.Square, bAdded);
+		if (bAdded) Search.Open(StartIndex);
+	}
+	// Distance to the closest finish door keeps the heuristic consistent for any number of finishes
+	auto Heuristic = [&](const FIntVector2 Square) -> uint32
+		{
+			uint32 Closest = MAX_uint32;
+			for (const auto& Door : Finishes)
+			{
+				Closest = FMath::Min(Closest, (uint32)(FMath::Abs(Square.X - Door.Key.X) + FMath::Abs(Square.Y - Door.Key.Y)));
+			}
+			return Closest;
+		};
+
+	// A straight corridor of the maximal length takes that many expansions, every source door gets such a budget,
+	// so a blocked door that wastes its expansions in a dead end does not starve the others
+	const int32 MaxExpansions = Input->MaxCorridorLength * Sources.Num();
+	int32 Expansions = 0;
+	bool finished = false;
+	int32 ResultIndex = INDEX_NONE;
+
+	while (!Search.IsOpenEmpty() && Expansions < MaxExpansions && !finished)
+	{
+		Expansions++;
+		const int32 QIndex = Search.PopOpen();
+		const FIntVector2 QPosition = Search.GetNode(QIndex).Position;
+		const uint32 QG = Search.GetNode(QIndex).G;
+		// Only start squares can be occupied, successors are checked before opening
+		if (IsSquareBlocked(QPosition, Width, PendingRoom)) continue;
+
+		const FIntVector2 Successors[4] = {
+			FIntVector2(QPosition.X + Width, QPosition.Y),
+			FIntVector2(QPosition.X - Width, QPosition.Y),
+			FIntVector2(QPosition.X, QPosition.Y + Width),
+			FIntVector2(QPosition.X, QPosition.Y - Width)
+		};
+		for (const auto& Successor : Successors)
+		{
+			bool bSkipSuccessor = false;
+			for (int32 FinishIndex = 0; FinishIndex < Finishes.Num() && !finished; FinishIndex++)
+			{
+				const TTuple<FIntVector2, FIntVector2>& Finish = Finishes[FinishIndex];
+				if (!(Finish.Key.X >= Successor.X &&
+					Finish.Key.X < Successor.X + Width &&
+					Finish.Key.Y >= Successor.Y &&
+					Finish.Key.Y < Successor.Y + Width)) continue;
+				// Skip successor if the doors are on the width size of corridor,
+				// accept finishing successor only from normal direction
+				if ((Finish.Key.X == Finish.Value.X &&
+					Successor.X == QPosition.X &&
+					Finish.Key.X - FinishRoom->Origin.X < Width) ||
+					(Finish.Key.Y == Finish.Value.Y &&
+					Successor.Y == QPosition.Y &&
+					Finish.Key.Y - FinishRoom->Origin.Y < Width) ||
+					(Finish.Key.X == Finish.Value.X &&
+					Successor.X == QPosition.X &&
+					FinishRoom->Origin.X + FinishRoom->Width - Finish.Key.X < Width) ||
+					(Finish.Key.Y == Finish.Value.Y &&
+					Successor.Y == QPosition.Y &&
+					FinishRoom->Origin.Y + FinishRoom->Height - Finish.Key.Y < Width))
+				{
+					bSkipSuccessor = true;
+					continue;
+				}
+
+				finished = true;
+				ResultIndex = QIndex;
+				OutFinishIndex = FinishIndex;
+				const FIntVector2 NewFinish = Ends[FinishIndex].Tile;
+				const EDirection FinishDirection = Ends[FinishIndex].Direction;
+				std::array<int, 2> MoveDirection = { {0, 0} };
+				std::array<int, 2> MoveDirectionWidth = { {0, 0} };
+				int FinishDistance = 0;
+				switch (FinishDirection)
+				{
+				case EDirection::LEFT:
+					MoveDirection[0] = -1;
+					MoveDirectionWidth[1] = 1;
+					FinishDistance = NewFinish.X - (QPosition.X + Width - 1);
+					break;
+				case EDirection::RIGHT:
+					MoveDirection[0] = 1;
+					MoveDirectionWidth[1] = 1;
+					FinishDistance = QPosition.X - NewFinish.X;
+					break;
+				case EDirection::UP:
+					MoveDirection[1] = 1;
+					MoveDirectionWidth[0] = 1;
+					FinishDistance = QPosition.Y - NewFinish.Y;
+					break;
+				case EDirection::DOWN:
+					MoveDirection[1] = -1;
+					MoveDirectionWidth[0] = 1;
+					FinishDistance = NewFinish.Y - (QPosition.Y + Width - 1);
+					break;
+				}
+				Corridor->Points.Reserve(Width * FMath::Max(0, FinishDistance + Width));
+				for (int WidthIndex = 0; WidthIndex < Width; WidthIndex++) {
+					for (int FinishStep = 0; FinishStep < FinishDistance + Width; FinishStep++)
+					{
+						// check if not overlaping with the end
+						if (FinishDirection == EDirection::UP &&
+							NewFinish.Y + FinishStep == QPosition.Y &&
+							NewFinish.X + WidthIndex <= QPosition.X) break;
+						if (FinishDirection == EDirection::DOWN &&
+							NewFinish.Y - FinishStep == QPosition.Y + Width - 1 &&
+							NewFinish.X + WidthIndex <= QPosition.X + Width - 1) break;
+						if (FinishDirection == EDirection::LEFT &&
+							NewFinish.X - FinishStep == QPosition.X + Width - 1 &&
+							NewFinish.Y + WidthIndex <= QPosition.Y) break;
+						if (FinishDirection == EDirection::RIGHT &&
+							NewFinish.X + FinishStep == QPosition.X &&
+							NewFinish.Y + WidthIndex <= QPosition.Y + Width - 1) break;
+						Corridor->Points.Add(
+							FIntVector2(FinishStep * MoveDirection[0], FinishStep * MoveDirection[1]) +
+							FIntVector2(WidthIndex * MoveDirectionWidth[0], WidthIndex * MoveDirectionWidth[1]) +
+							NewFinish);
+					}
+				}
+			}
+			if (finished) break;
+			if (bSkipSuccessor) continue;
+			const uint32 G = QG + Width;
+			// Every path through a successor past the length limit would be rejected at the end anyway
+			if (G / Width >= (uint32)Input->MaxCorridorLength) continue;
+			if (IsSquareBlocked(Successor, Width, PendingRoom)) continue;
+			const uint32 H = Heuristic(Successor);
+			bool bAdded;
+			const int32 SuccessorIndex = Search.FindOrAddNode(Successor, bAdded);
+			FCorridorSearch::FNode& SuccessorNode = Search.GetNode(SuccessorIndex);
+			// Closed nodes are reopened when reached with a lower cost
+			if (bAdded || G < SuccessorNode.G)
+			{
+				SuccessorNode.Parent = QIndex;
+				SuccessorNode.G = G;
+				SuccessorNode.F = G + H;
+				Search.Open(SuccessorIndex);
+			}
+		}
+	}
+	int32 ResultLength(0);
+	if (finished)
+	{
+		int32 RootIndex = ResultIndex;
+		for (int32 NodeIndex = ResultIndex; NodeIndex != INDEX_NONE; NodeIndex = Search.GetNode(NodeIndex).Parent)
+		{
+			RootIndex = NodeIndex;
+			ResultLength++;
+		}
+		Corridor->Squares.Reserve(ResultLength);
+		for (int32 NodeIndex = ResultIndex; NodeIndex != INDEX_NONE; NodeIndex = Search.GetNode(NodeIndex).Parent)
+		{
+			Corridor->Squares.Add(Search.GetNode(NodeIndex).Position);
+		}
+		// Path root identifies the source door it started from
+		OutSourceIndex = Starts.IndexOfByPredicate([&](const FCorridorStart& Start)
+			{
+				return Start.Square == Search.GetNode(RootIndex).Position;
+			});
+		Corridor->StartBot = Starts[OutSourceIndex].Bot;
+		Corridor->StartTop = Starts[OutSourceIndex].Top;
+		Corridor->EndBot = Ends[OutFinishIndex].Bot;
+		Corridor->EndTop = Ends[OutFinishIndex].Top;
+	}
+	return finished && ResultLength <= Input->MaxCorridorLength;
+};
+
+void FDungeonLayoutGenerator::BuildPlacementPlan(const int32 InitialNode, TArray<FPlacementStep>& OutSteps, TArray<int32>& OutNodeSteps) const
+{
+	OutSteps.Reset();
+	OutNodeSteps.Init(INDEX_NONE, Input->Nodes.Num());
+	OutSteps.AddDefaulted_GetRef().Node = InitialNode;
+	OutNodeSteps[InitialNode] = 0;
+
+	TSet<TPair<int32, int32>> ConnectedNodes;
+	TQueue<int32> NodeQueue;
+	NodeQueue.Enqueue(InitialNode);
+	int32 NodeToProcess;
+	while (NodeQueue.Dequeue(NodeToProcess))
+	{
+		for (const FDungeonLayoutInput::FNeighbour& Neighbour : Input->Nodes[NodeToProcess].Neighbours)
+		{
+			const int32 NeighbourNode = Neighbour.Node;
+			if (ConnectedNodes.Contains(TPair<int32, int32>(NodeToProcess, NeighbourNode))) continue;
+			if (OutNodeSteps[NeighbourNode] != INDEX_NONE)
+			{
+				// Cycle edge is closed right after the later of its two rooms is placed
+				const int32 ClosingStep = FMath::Max(OutNodeSteps[NodeToProcess], OutNodeSteps[NeighbourNode]);
+				OutSteps[ClosingStep].CycleEdges.Emplace(NodeToProcess, NeighbourNode, Neighbour.Edge);
+			}
+			else
+			{
+				FPlacementStep& Step = OutSteps.AddDefaulted_GetRef();
+				Step.ParentNode = NodeToProcess;
+				Step.Node = NeighbourNode;
+				Step.Edge = Neighbour.Edge;
+				OutNodeSteps[NeighbourNode] = OutSteps.Num() - 1;
+			}
+			NodeQueue.Enqueue(NeighbourNode);
+			ConnectedNodes.Add(TPair<int32, int32>(NodeToProcess, NeighbourNode));
+			ConnectedNodes.Add(TPair<int32, int32>(NeighbourNode, NodeToProcess));
+		}
+	}
+}
+
+bool FDungeonLayoutGenerator::ExecuteStep(const TArray<FPlacementStep>& Steps, const int32 StepIndex, const uint32 Execution,
+	const TArray<int32>& NodeSteps, int32& OutFailedCycleEdge)
+{
+	const FPlacementStep& Step = Steps[StepIndex];
+	const FDungeonLayoutInput::FNode& Node = Input->Nodes[Step.Node];
+	InvalidSeed = false;
+	OutFailedCycleEdge = INDEX_NONE;
+	if (Step.ParentNode == INDEX_NONE)
+	{
+		// Construct initial room
+		URoom* InitialRoom = AddRoom();
+		InitialRoom->Width = Node.Width;
+		InitialRoom->Height = Node.Height;
+		InitialRoom->Origin = FIntVector2(0, 0);
+		InitialRoom->LocalTheme = Node.RoomTheme;
+		InsertOccupiedTiles(InitialRoom);
+	}
+	else
+	{
+		URoom* ParentRoom = AllRooms[NodeSteps[Step.ParentNode]];
+		RandomStream.Initialize(FDerivedSeed::Get(LayoutSeed, FDerivedSeed::Room, StepIndex, Execution));
+		URoom* NewRoom = ConnectWithNew(ParentRoom, Node, Input->Edges[Step.Edge]);
+		if (InvalidSeed) return false;
+		Connect(ParentRoom, NewRoom);
+	}
+	for (int32 CycleIndex = 0; CycleIndex < Step.CycleEdges.Num(); CycleIndex++)
+	{
+		const auto& CycleEdge = Step.CycleEdges[CycleIndex];
+		RandomStream.Initialize(FDerivedSeed::Get(LayoutSeed, FDerivedSeed::Edge, Step.FirstCycleEdge + CycleIndex, Execution));
+		URoom* ParentRoom = AllRooms[NodeSteps[CycleEdge.Get<0>()]];
+		URoom* ChildRoom = AllRooms[NodeSteps[CycleEdge.Get<1>()]];
+		if (!ConnectWithExisting(ParentRoom, ChildRoom, Input->Edges[CycleEdge.Get<2>()]))
+		{
+			OutFailedCycleEdge = CycleIndex;
+			return false;
+		}
+		Connect(ParentRoom, ChildRoom);
+	}
+	return true;
+}
+
+FDungeonLayoutGenerator::URoom* FDungeonLayoutGenerator::AddRoom()
+{
+	URoom* Room = AllRooms.Add_GetRef(new(Arena, 1, alignof(URoom)) URoom());
+	Journal.Add({ FJournalEntry::RoomAdded, Room });
+	return Room;
+}
+
+void FDungeonLayoutGenerator::UseSegment(URoom* Room, URoomSegment& Segment, const TTuple<FIntVector2, FIntVector2>& Door)
+{
+	FJournalEntry& Entry = Journal.Add_GetRef({ FJournalEntry::SegmentChanged, Room });
+	Entry.SegmentIndex = UE_PTRDIFF_TO_INT32(&Segment - Room->Segments.GetData());
+	Entry.Door = Segment.Door;
+	Entry.bWasUsed = Segment.bIsUsed;
+	Segment.Door = Door;
+	Segment.bIsUsed = true;
+	bool bIsAlreadyInSet;
+	Room->Doors.Add(Door, &bIsAlreadyInSet);
+	if (!bIsAlreadyInSet) Journal.Add({ FJournalEntry::DoorAdded, Room, nullptr, INDEX_NONE, false, Door });
+}
+
+void FDungeonLayoutGenerator::Connect(URoom* Room, URoom* OtherRoom)
+{
+	for (URoom* From : { Room, OtherRoom })
+	{
+		URoom* To = From == Room ? OtherRoom : Room;
+		bool bIsAlreadyInSet;
+		From->Connections.Add(To, &bIsAlreadyInSet);
+		if (!bIsAlreadyInSet) Journal.Add({ FJournalEntry::ConnectionAdded, From, To });
+	}
+}
+
+FDungeonLayoutGenerator::FSavepoint FDungeonLayoutGenerator::MakeSavepoint() const
+{
+	return { Journal.Num(), OccupiedTiles.GetJournalPosition() };
+}
+
+void FDungeonLayoutGenerator::RollbackTo(const FSavepoint& Savepoint)
+{
+	// Entries are undone newest first, so every entry sees the state right after its own change
+	while (Journal.Num() > Savepoint.JournalPosition)
+	{
+		const FJournalEntry Entry = Journal.Pop(false);
+		switch (Entry.Type)
+		{
+		case FJournalEntry::RoomAdded:
+			check(AllRooms.Last() == Entry.Room);
+			// Arena memory of the room is reclaimed with the whole arena
+			AllRooms.Pop(false)->~URoom();
+			break;
+		case FJournalEntry::CorridorAdded:
+			AllCorridors.Pop(false);
+			break;
+		case FJournalEntry::DoorAdded:
+			Entry.Room->Doors.Remove(Entry.Door);
+			break;
+		case FJournalEntry::SegmentChanged:
+			Entry.Room->Segments[Entry.SegmentIndex].Door = Entry.Door;
+			Entry.Room->Segments[Entry.SegmentIndex].bIsUsed = Entry.bWasUsed;
+			break;
+		case FJournalEntry::ConnectionAdded:
+			Entry.Room->Connections.Remove(Entry.OtherRoom);
+			break;
+		}
+	}
+	OccupiedTiles.RollbackTo(Savepoint.OccupancyPosition);
+}
+
+bool FDungeonLayoutGenerator::Generate(const FDungeonLayoutInput& LayoutInput, const int32 Seed, FDungeonLayoutProgress* Progress)
+{
+	Input = &LayoutInput;
+	LayoutSeed = Seed;
+	if (Input->Nodes.Num() == 0) return false;
+	ReleaseRooms();
+	AllCorridors.Empty();
+	OccupiedTiles.Empty();
+	Journal.Reset();
+	InvalidSeed = false;
+
+	// Node with most neighbours, or first with four (allowed maximum)
+	int32 InitialNode = 0;
+	for (int32 Node = 1; Node < Input->Nodes.Num(); Node++)
+	{
+		if (Input->Nodes[Node].Neighbours.Num() > Input->Nodes[InitialNode].Neighbours.Num())
+			InitialNode = Node;
+	}
+	TArray<FPlacementStep> Steps;
+	TArray<int32> NodeSteps;
+	BuildPlacementPlan(InitialNode, Steps, NodeSteps);
+	// Plan knows the exact number of rooms and corridors
+	int32 CorridorCount = Steps.Num() - 1;
+	for (FPlacementStep& Step : Steps)
+	{
+		Step.FirstCycleEdge = CorridorCount - (Steps.Num() - 1);
+		CorridorCount += Step.CycleEdges.Num();
+	}
+	AllRooms.Reserve(Steps.Num());
+	AllCorridors.Reserve(CorridorCount);
+
+	// Failed step is retried from its savepoint, after MaxStepAttempts an earlier placement is undone too.
+	// For a failed cycle edge it is the step that placed the other room of the edge, so that room gets a new
+	// position, for a failed room it is the previous step. Either way only rooms placed since then are moved
+	// instead of discarding the whole seed
+	TArray<FSavepoint> Savepoints;
+	Savepoints.SetNum(Steps.Num());
+	TArray<int32> StepAttempts;
+	StepAttempts.SetNumZeroed(Steps.Num());
+	// Every execution of a step draws from its own stream, derived from the seed, step and execution count,
+	// so results never depend on how many numbers earlier steps consumed
+	TArray<uint32> StepExecutions;
+	StepExecutions.SetNumZeroed(Steps.Num());
+	int32 Backtracks(0);
+	int32 StepIndex(0);
+	while (StepIndex < Steps.Num())
+	{
+		if (Progress && Progress->bCancelled) return false;
+		if (StepAttempts[StepIndex] == 0) Savepoints[StepIndex] = MakeSavepoint();
+		StepAttempts[StepIndex]++;
+		int32 FailedCycleEdge;
+		if (ExecuteStep(Steps, StepIndex, StepExecutions[StepIndex]++, NodeSteps, FailedCycleEdge))
+		{
+			if (Progress) Progress->Report(AllRooms.Num(), AllCorridors.Num());
+			StepIndex++;
+			continue;
+		}
+		// Initial room is always at the origin, undoing it changes nothing
+		if (StepIndex == 0 || ++Backtracks > Input->MaxBacktrackingSteps)
+		{
+			InvalidSeed = true;
+			break;
+		}
+		if (StepAttempts[StepIndex] >= MaxStepAttempts && StepIndex > 1)
+		{
+			int32 BacktrackStep = StepIndex - 1;
+			if (FailedCycleEdge != INDEX_NONE)
+			{
+				// Later room of a cycle edge is the one of this step, the earlier one is placed by an older step
+				const auto& CycleEdge = Steps[StepIndex].CycleEdges[FailedCycleEdge];
+				const int32 EndpointStep = FMath::Min(NodeSteps[CycleEdge.Get<0>()], NodeSteps[CycleEdge.Get<1>()]);
+				// Initial room never moves, the previous step is undone instead
+				if (EndpointStep > 0 && EndpointStep < StepIndex) BacktrackStep = EndpointStep;
+			}
+			// Undone steps take new savepoints when they are executed again
+			for (int32 UndoneStep = BacktrackStep + 1; UndoneStep <= StepIndex; UndoneStep++)
+			{
+				StepAttempts[UndoneStep] = 0;
+			}
+			StepIndex = BacktrackStep;
+		}
+		RollbackTo(Savepoints[StepIndex]);
+	}
+	if (InvalidSeed) return false;
+	return true;
+}
+
+namespace
+{
+	// Orthogonal neighbour bits of the corridor tile classification
+	constexpr uint8 LeftBit = 1 << 0;
+	constexpr uint8 RightBit = 1 << 1;
+	constexpr uint8 DownBit = 1 << 2;
+	constexpr uint8 UpBit = 1 << 3;
+
+	// Corridor grid cell flags
+	constexpr uint8 PathCell = 1 << 0;
+	constexpr uint8 BorderCell = 1 << 1;
+
+	struct FTileClass
+	{
+		bool bValid = false;
+		EDungeonTileType Type = EDungeonTileType::CorridorFloor;
+		int32 Yaw = 0;
+	};
+
+	constexpr int32 CountBits(const int32 Mask)
+	{
+		return (Mask & 1) + (Mask >> 1 & 1) + (Mask >> 2 & 1) + (Mask >> 3 & 1);
+	}
+
+	// Yaw of a corner whose two sides face the given directions
+	constexpr int32 CornerYaw(const int32 Sides)
+	{
+		if (Sides == (UpBit | LeftBit)) return -90;
+		if (Sides == (UpBit | RightBit)) return 180;
+		if (Sides == (DownBit | RightBit)) return 90;
+		return 0;
+	}
+
+	// Indexed by mask of missing orthogonal neighbours
+	constexpr std::array<FTileClass, 16> MakeBorderClasses()
+	{
+		std::array<FTileClass, 16> Classes{};
+		for (int32 Missing = 0; Missing < 16; Missing++)
+		{
+			if (CountBits(Missing) == 1)
+			{
+				const int32 Yaw = Missing == UpBit ? -90 : Missing == DownBit ? 90 : Missing == LeftBit ? 0 : 180;
+				Classes[Missing] = FTileClass{ true, EDungeonTileType::CorridorWall, Yaw };
+			}
+			else if (CountBits(Missing) == 2)
+			{
+				Classes[Missing] = FTileClass{ true, EDungeonTileType::CorridorWallOutsideCorner, CornerYaw(Missing) };
+			}
+		}
+		return Classes;
+	}
+
+	// Low four bits mark orthogonal neighbours that are walls or outside corners, high four bits mark missing diagonal neighbours
+	constexpr std::array<FTileClass, 256> MakeInsideCornerClasses()
+	{
+		std::array<FTileClass, 256> Classes{};
+		for (int32 Mask = 0; Mask < 256; Mask++)
+		{
+			const int32 Sides = Mask & 0xF;
+			const bool bPerpendicular = CountBits(Sides) == 2 && Sides != (LeftBit | RightBit) && Sides != (DownBit | UpBit);
+			if (bPerpendicular && Mask >> 4 != 0)
+			{
+				Classes[Mask] = FTileClass{ true, EDungeonTileType::CorridorWallInsideCorner, CornerYaw(Sides) };
+			}
+		}
+		return Classes;
+	}
+
+	constexpr std::array<FTileClass, 16> BorderClasses = MakeBorderClasses();
+	constexpr std::array<FTileClass, 256> InsideCornerClasses = MakeInsideCornerClasses();
+}
+
+void FDungeonLayoutGenerator::BuildLayout(FDungeonLayout& OutLayout) const
+{
+	OutLayout.Empty();
+	OutLayout.Seed = LayoutSeed;
+	UGraphToDungeonTheme* LevelTheme = nullptr;
+	// Every emitted tile goes through the ownership map, so each position ends up with exactly one tile,
+	// the one with the highest priority, or the first emitted one among equal priorities
+	TMap<FIntVector2, int32> TileOwners;
+	// Room or corridor of every emitted tile, numbered in emission order, INDEX_NONE once a later unit wins the position
+	TArray<int32> TileUnits;
+	int32 Unit = INDEX_NONE;
+	auto AddTile = [&OutLayout, &LevelTheme, &TileOwners, &TileUnits, &Unit](const FIntVector2 Position, const EDungeonTileType Type, const int32 Yaw)
+		{
+			FDungeonTile NewTile;
+			NewTile.Position = Position;
+			NewTile.Type = Type;
+			NewTile.Yaw = Yaw;
+			NewTile.Theme = LevelTheme;
+			if (int32* Owner = TileOwners.Find(Position))
+			{
+				FDungeonTile& OwnerTile = OutLayout.Tiles[*Owner];
+				if (NewTile.GetPriority() <= OwnerTile.GetPriority()) return;
+				if (TileUnits[*Owner] == Unit)
+				{
+					OwnerTile = NewTile;
+					return;
+				}
+				// Tile won over an earlier unit moves to this one, so tile ranges hold only tiles of their own unit
+				TileUnits[*Owner] = INDEX_NONE;
+				*Owner = OutLayout.Tiles.Add(NewTile);
+				TileUnits.Add(Unit);
+				return;
+			}
+			TileOwners.Add(Position, OutLayout.Tiles.Add(NewTile));
+			TileUnits.Add(Unit);
+		};
+	for (const URoom* Room : AllRooms)
+	{
+		LevelTheme = Room->LocalTheme;
+		Unit = OutLayout.Rooms.Num();
+		FDungeonLayoutRoom& LayoutRoom = OutLayout.Rooms.AddDefaulted_GetRef();
+		LayoutRoom.Origin = Room->Origin;
+		LayoutRoom.Width = Room->Width;
+		LayoutRoom.Height = Room->Height;
+		LayoutRoom.Doors = Room->Doors.Array();
+		LayoutRoom.Theme = LevelTheme;
+
+		TSet<FIntVector2> DoorPositions;
+		// Room door tiles
+		for (const auto& Door : Room->Doors)
+		{
+			if (Door.Key.X == Door.Value.X)
+			{
+				// Left
+				if (Door.Key.X == Room->Origin.X)
+				{
+					DoorPositions.Add(FIntVector2(Door.Key.X, Door.Value.Y));
+					AddTile(FIntVector2(Door.Key.X, Door.Value.Y), EDungeonTileType::RoomDoorLeftFrame, 0);
+					DoorPositions.Add(FIntVector2(Door.Key.X, Door.Key.Y));
+					AddTile(FIntVector2(Door.Key.X, Door.Key.Y), EDungeonTileType::RoomDoorRightFrame, 0);
+					for (int32 HeightIndex = 1; Door.Key.Y + HeightIndex < Door.Value.Y; HeightIndex++)
+					{
+						const FIntVector2 DoorPosition(Door.Key.X, Door.Key.Y + HeightIndex);
+						DoorPositions.Add(DoorPosition);
+						AddTile(DoorPosition, EDungeonTileType::RoomDoor, 0);
+					}
+				}
+				else
+				{
+					DoorPositions.Add(FIntVector2(Door.Key.X, Door.Key.Y));
+					AddTile(FIntVector2(Door.Key.X, Door.Key.Y), EDungeonTileType::RoomDoorLeftFrame, 180);
+					DoorPositions.Add(FIntVector2(Door.Key.X, Door.Value.Y));
+					AddTile(FIntVector2(Door.Key.X, Door.Value.Y), EDungeonTileType::RoomDoorRightFrame, 180);
+					for (int32 HeightIndex = 1; Door.Key.Y + HeightIndex < Door.Value.Y; HeightIndex++)
+					{
+						const FIntVector2 DoorPosition(Door.Key.X, Door.Key.Y + HeightIndex);
+						DoorPositions.Add(DoorPosition);
+						AddTile(DoorPosition, EDungeonTileType::RoomDoor, 180);
+					}
+				}
+			}
+			else if (Door.Key.Y == Door.Value.Y)
+			{
+				// Bottom
+				if (Door.Key.Y == Room->Origin.Y)
+				{
+					DoorPositions.Add(FIntVector2(Door.Key.X, Door.Key.Y));
+					AddTile(FIntVector2(Door.Key.X, Door.Key.Y), EDungeonTileType::RoomDoorLeftFrame, 90);
+					DoorPositions.Add(FIntVector2(Door.Value.X, Door.Key.Y));
+					AddTile(FIntVector2(Door.Value.X, Door.Key.Y), EDungeonTileType::RoomDoorRightFrame, 90);
+					for (int32 WidthIndex = 1; Door.Key.X + WidthIndex < Door.Value.X; WidthIndex++)
+					{
+						const FIntVector2 DoorPosition(Door.Key.X + WidthIndex, Door.Key.Y);
+						DoorPositions.Add(DoorPosition);
+						AddTile(DoorPosition, EDungeonTileType::RoomDoor, 90);
+					}
+				}
+				else
+				{
+					DoorPositions.Add(FIntVector2(Door.Value.X, Door.Key.Y));
+					AddTile(FIntVector2(Door.Value.X, Door.Key.Y), EDungeonTileType::RoomDoorLeftFrame, -90);
+					DoorPositions.Add(FIntVector2(Door.Key.X, Door.Key.Y));
+					AddTile(FIntVector2(Door.Key.X, Door.Key.Y), EDungeonTileType::RoomDoorRightFrame, -90);
+					for (int32 WidthIndex = 1; Door.Key.X + WidthIndex < Door.Value.X; WidthIndex++)
+					{
+						const FIntVector2 DoorPosition(Door.Key.X + WidthIndex, Door.Key.Y);
+						DoorPositions.Add(DoorPosition);
+						AddTile(DoorPosition, EDungeonTileType::RoomDoor, -90);
+					}
+				}
+			}
+		}
+		const FIntVector2 Origin = Room->Origin;
+		// Room corners
+		const FIntVector2 WallCornerPositionBotLeft(Origin.X, Origin.Y);
+		const FIntVector2 WallCornerPositionBotRight(Origin.X + Room->Width - 1, Origin.Y);
+		const FIntVector2 WallCornerPositionTopLeft(Origin.X, Origin.Y + Room->Height - 1);
+		const FIntVector2 WallCornerPositionTopRight(Origin.X + Room->Width - 1, Origin.Y + Room->Height - 1);
+		if (!DoorPositions.Contains(WallCornerPositionBotLeft)) AddTile(WallCornerPositionBotLeft, EDungeonTileType::RoomWallCorner, 0);
+		if (!DoorPositions.Contains(WallCornerPositionBotRight)) AddTile(WallCornerPositionBotRight, EDungeonTileType::RoomWallCorner, 90);
+		if (!DoorPositions.Contains(WallCornerPositionTopLeft)) AddTile(WallCornerPositionTopLeft, EDungeonTileType::RoomWallCorner, -90);
+		if (!DoorPositions.Contains(WallCornerPositionTopRight)) AddTile(WallCornerPositionTopRight, EDungeonTileType::RoomWallCorner, 180);
+		// Room walls and floor
+		for (int32 ii = 0; ii < Room->Width; ii++)
+		{
+			if (ii > 0 && ii < Room->Width - 1)
+			{
+				const FIntVector2 WallPositionBot(Origin.X + ii, Origin.Y);
+				const FIntVector2 WallPositionTop(Origin.X + ii, Origin.Y + Room->Height - 1);
+				if (!DoorPositions.Contains(WallPositionBot)) AddTile(WallPositionBot, EDungeonTileType::RoomWall, 90);
+				if (!DoorPositions.Contains(WallPositionTop)) AddTile(WallPositionTop, EDungeonTileType::RoomWall, -90);
+			}
+			for (int32 jj = 0; jj < Room->Height; jj++)
+			{
+				if (jj > 0 && jj < Room->Height - 1 && ii == 0)
+				{
+					const FIntVector2 WallPositionLeft(Origin.X, Origin.Y + jj);
+					const FIntVector2 WallPositionRight(Origin.X + Room->Width - 1, Origin.Y + jj);
+					if (!DoorPositions.Contains(WallPositionLeft)) AddTile(WallPositionLeft, EDungeonTileType::RoomWall, 0);
+					if (!DoorPositions.Contains(WallPositionRight)) AddTile(WallPositionRight, EDungeonTileType::RoomWall, 180);
+				}
+				AddTile(FIntVector2(Origin.X + ii, Origin.Y + jj), EDungeonTileType::RoomFloor, 0);
+			}
+		}
+	}
+	for (const UCorridor& Corridor : AllCorridors)
+	{
+		LevelTheme = Corridor.LocalTheme;
+		Unit = OutLayout.Rooms.Num() + OutLayout.Corridors.Num();
+
+		// Dense grid over corridor bounds padded by one tile, so every neighbour lookup stays inside
+		FIntVector2 Min(MAX_int32, MAX_int32);
+		FIntVector2 Max(MIN_int32, MIN_int32);
+		for (const auto& Square : Corridor.Squares)
+		{
+			Min = FIntVector2(FMath::Min(Min.X, Square.X), FMath::Min(Min.Y, Square.Y));
+			Max = FIntVector2(FMath::Max(Max.X, Square.X + Corridor.Width - 1), FMath::Max(Max.Y, Square.Y + Corridor.Width - 1));
+		}
+		for (const auto& Point : Corridor.Points)
+		{
+			Min = FIntVector2(FMath::Min(Min.X, Point.X), FMath::Min(Min.Y, Point.Y));
+			Max = FIntVector2(FMath::Max(Max.X, Point.X), FMath::Max(Max.Y, Point.Y));
+		}
+		if (Min.X > Max.X) continue;
+		Min -= FIntVector2(1, 1);
+		Max += FIntVector2(1, 1);
+		const int32 GridWidth = Max.X - Min.X + 1;
+		const int32 GridHeight = Max.Y - Min.Y + 1;
+		TArray<uint8> Grid;
+		Grid.SetNumZeroed(GridWidth * GridHeight);
+		auto CellIndex = [&Min, GridWidth](const FIntVector2 Tile) { return (Tile.Y - Min.Y) * GridWidth + Tile.X - Min.X; };
+
+		for (const auto& Square : Corridor.Squares)
+		{
+			// Floor using squares
+			for (int32 j = 0; j < Corridor.Width; j++)
+			{
+				for (int32 k = 0; k < Corridor.Width; k++)
+				{
+					FIntVector2 PointOnPath(j + Square.X, k + Square.Y);
+					Grid[CellIndex(PointOnPath)] |= PathCell;
+					AddTile(PointOnPath, EDungeonTileType::CorridorFloor, 0);
+				}
+			}
+		}
+		// Floor using specific points
+		for (const auto& Point : Corridor.Points)
+		{
+			Grid[CellIndex(Point)] |= PathCell;
+			AddTile(Point, EDungeonTileType::CorridorFloor, 0);
+		}
+		FDungeonLayoutCorridor& LayoutCorridor = OutLayout.Corridors.AddDefaulted_GetRef();
+		LayoutCorridor.Width = Corridor.Width;
+		LayoutCorridor.Theme = LevelTheme;
+
+		// Tiles between door frames never become walls
+		auto IsDoorInterior = [&Corridor](const FIntVector2 Point) -> bool
+			{
+				if (Point == Corridor.StartBot || Point == Corridor.StartTop ||
+					Point == Corridor.EndBot || Point == Corridor.EndTop) return false;
+				return Corridor.StartBot.X == Corridor.StartTop.X && Point.X == Corridor.StartBot.X &&
+					Point.Y > Corridor.StartBot.Y && Point.Y < Corridor.StartTop.Y ||
+					Corridor.StartBot.Y == Corridor.StartTop.Y && Point.Y == Corridor.StartBot.Y &&
+					Point.X > Corridor.StartBot.X && Point.X < Corridor.StartTop.X ||
+					Corridor.EndBot.X == Corridor.EndTop.X && Point.X == Corridor.EndBot.X &&
+					Point.Y > Corridor.EndBot.Y && Point.Y < Corridor.EndTop.Y ||
+					Corridor.EndBot.Y == Corridor.EndTop.Y && Point.Y == Corridor.EndBot.Y &&
+					Point.X > Corridor.EndBot.X && Point.X < Corridor.EndTop.X;
+			};
+		// Mask of orthogonal neighbours having all of the given cell flags
+		auto SideMask = [&Grid, GridWidth](const int32 Index, const uint8 Flags) -> uint8
+			{
+				return ((Grid[Index - 1] & Flags) == Flags ? LeftBit : 0) |
+					((Grid[Index + 1] & Flags) == Flags ? RightBit : 0) |
+					((Grid[Index - GridWidth] & Flags) == Flags ? DownBit : 0) |
+					((Grid[Index + GridWidth] & Flags) == Flags ? UpBit : 0);
+			};
+
+		// Walls and outside corners, classified by missing orthogonal neighbours
+		for (int32 Y = 1; Y < GridHeight - 1; Y++)
+		{
+			for (int32 X = 1; X < GridWidth - 1; X++)
+			{
+				const int32 Index = Y * GridWidth + X;
+				if (!(Grid[Index] & PathCell)) continue;
+				const FIntVector2 Point(Min.X + X, Min.Y + Y);
+				LayoutCorridor.Tiles.Add(Point);
+				if (IsDoorInterior(Point)) continue;
+				const FTileClass& Class = BorderClasses[~SideMask(Index, PathCell) & 0xF];
+				if (!Class.bValid) continue;
+				Grid[Index] |= BorderCell;
+				AddTile(Point, Class.Type, Class.Yaw);
+			}
+		}
+		// Inside corners, classified by border neighbours and missing diagonal neighbours
+		for (int32 Y = 1; Y < GridHeight - 1; Y++)
+		{
+			for (int32 X = 1; X < GridWidth - 1; X++)
+			{
+				const int32 Index = Y * GridWidth + X;
+				if ((Grid[Index] & (PathCell | BorderCell)) != PathCell) continue;
+				const uint8 MissingDiagonals =
+					(Grid[Index + GridWidth + 1] & PathCell ? 0 : 1) |
+					(Grid[Index - GridWidth + 1] & PathCell ? 0 : 2) |
+					(Grid[Index + GridWidth - 1] & PathCell ? 0 : 4) |
+					(Grid[Index - GridWidth - 1] & PathCell ? 0 : 8);
+				const FTileClass& Class = InsideCornerClasses[SideMask(Index, PathCell | BorderCell) | MissingDiagonals << 4];
+				if (Class.bValid) AddTile(FIntVector2(Min.X + X, Min.Y + Y), Class.Type, Class.Yaw);
+			}
+		}
+	}
+
+	// Tiles taken over by later units are dropped, the rest stays grouped by unit in emission order
+	TArray<int32> UnitTileCounts;
+	UnitTileCounts.SetNumZeroed(OutLayout.Rooms.Num() + OutLayout.Corridors.Num());
+	int32 KeptTileCount = 0;
+	for (int32 TileIndex = 0; TileIndex < OutLayout.Tiles.Num(); TileIndex++)
+	{
+		if (TileUnits[TileIndex] == INDEX_NONE) continue;
+		UnitTileCounts[TileUnits[TileIndex]]++;
+		OutLayout.Tiles[KeptTileCount++] = OutLayout.Tiles[TileIndex];
+	}
+	OutLayout.Tiles.SetNum(KeptTileCount, false);
+	int32 FirstTile = 0;
+	for (int32 RoomIndex = 0; RoomIndex < OutLayout.Rooms.Num(); RoomIndex++)
+	{
+		OutLayout.Rooms[RoomIndex].FirstTile = FirstTile;
+		OutLayout.Rooms[RoomIndex].TileCount = UnitTileCounts[RoomIndex];
+		FirstTile += UnitTileCounts[RoomIndex];
+	}
+	for (int32 CorridorIndex = 0; CorridorIndex < OutLayout.Corridors.Num(); CorridorIndex++)
+	{
+		OutLayout.Corridors[CorridorIndex].FirstTile = FirstTile;
+		OutLayout.Corridors[CorridorIndex].TileCount = UnitTileCounts[OutLayout.Rooms.Num() + CorridorIndex];
+		FirstTile += UnitTileCounts[OutLayout.Rooms.Num() + CorridorIndex];
+	}
+}
@@ -0,0 +1,279 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/MemStack.h"
+#include "GraphToDungeonTheme.h"
+#include "OccupancyGrid.h"
+#include "CorridorSearch.h"
+#include "DungeonLayout.h"
+
+/**
+ * @brief Places rooms and corridors of the level graph on a tile grid, without touching the world.
+ * Every instance owns all of its state and random stream, so several seeds can be tried at once on worker threads
+ */
+class FDungeonLayoutGenerator
+{
+public:
+	// Possible directions of the segments
+	enum EDirection {
+		UP,
+		DOWN,
+		LEFT,
+		RIGHT
+	};
+	/**
+	 * @brief Represents temporary corridor object
+	 */
+	struct UCorridor
+	{
+		TArray<FIntVector2> Squares;
+		TArray<FIntVector2> Points;
+		int32 Width = 0;
+		UGraphToDungeonTheme* LocalTheme = nullptr;
+		FIntVector2 StartBot;
+		FIntVector2 EndBot;
+		FIntVector2 StartTop;
+		FIntVector2 EndTop;
+	};
+	struct URoomSegment
+	{
+		TTuple<FIntVector2, FIntVector2> Door;
+		bool bIsUsed = false;
+		const EDirection Direction;
+
+		URoomSegment(const EDirection Direction) : Direction(Direction) {}
+	};
+	/**
+	 * @brief Represents temporary room object
+	 */
+	struct URoom
+	{
+		int32 Width;
+		int32 Height;
+		FIntVector2 Origin;
+		// Rooms have at most a few doors and connections, inline storage keeps them off the heap
+		TSet<TTuple<FIntVector2, FIntVector2>, DefaultKeyFuncs<TTuple<FIntVector2, FIntVector2>>, TInlineSetAllocator<4>> Doors;
+		UGraphToDungeonTheme* LocalTheme;
+		TArray<URoomSegment, TInlineAllocator<4>> Segments = {
+			URoomSegment(EDirection::DOWN),
+			URoomSegment(EDirection::RIGHT),
+			URoomSegment(EDirection::UP),
+			URoomSegment(EDirection::LEFT)};
+		TSet<URoom*, DefaultKeyFuncs<URoom*>, TInlineSetAllocator<4>> Connections;
+
+		// Accessors instead of reference members keep the room safely copyable
+		URoomSegment& DownSegment() { return Segments[0]; }
+		URoomSegment& RightSegment() { return Segments[1]; }
+		URoomSegment& UpSegment() { return Segments[2]; }
+		URoomSegment& LeftSegment() { return Segments[3]; }
+		URoomSegment& GetSegment(const EDirection Direction)
+		{
+			return *Segments.FindByPredicate([Direction](const URoomSegment& Segment) { return Segment.Direction == Direction; });
+		}
+	};
+
+	FDungeonLayoutGenerator() = default;
+	FDungeonLayoutGenerator(const FDungeonLayoutGenerator&) = delete;
+	FDungeonLayoutGenerator& operator=(const FDungeonLayoutGenerator&) = delete;
+	~FDungeonLayoutGenerator();
+
+	/**
+	 * @brief Generates layout from a copy of the level graph, touches no UObjects so it is safe to call from any thread
+	 * @param LayoutInput Graph and properties, must outlive the generator
+	 * @param Seed Seed of the layout random stream
+	 * @param Progress Optional progress reported after every placement step and checked for cancellation
+	 * @return True - successfull generation, False - otherwise or cancelled
+	 */
+	bool Generate(const FDungeonLayoutInput& LayoutInput, const int32 Seed, FDungeonLayoutProgress* Progress = nullptr);
+
+	/**
+	 * @brief Converts generated rooms and corridors into plain data and classifies all their tiles
+	 * @param OutLayout Layout to be filled, previous content is removed
+	 */
+	void BuildLayout(FDungeonLayout& OutLayout) const;
+
+private:
+	// Tests drive the journaled operations, the corridor search and classify hand made corridors directly
+	friend class FDungeonLayoutGeneratorRollbackTest;
+	friend class FDungeonLayoutMultiSourceSearchTest;
+	friend class FDungeonLayoutCorridorClassificationTest;
+
+	bool InvalidSeed = false;
+	int32 LayoutSeed = 0;
+	const FDungeonLayoutInput* Input = nullptr;
+	// Stream of the room or edge being placed, reseeded by ExecuteStep from the layout seed
+	FRandomStream RandomStream;
+
+	// Linear arena holding all rooms of one generation, released at once by ReleaseRooms
+	FMemStackBase Arena;
+	TArray<URoom*> AllRooms;
+	TArray<UCorridor> AllCorridors;
+	FOccupancyGrid OccupiedTiles;
+	// Corridor search buffers reused by every FindAWay call
+	FCorridorSearch Search;
+
+	// Destroys all rooms and frees the arena
+	void ReleaseRooms();
+
+	/**
+	 * @brief One step of the breadth first placement, creates room of the node
+	 * and closes every cycle edge whose both rooms exist after it
+	 */
+	struct FPlacementStep
+	{
+		// Input node and edge indices, INDEX_NONE parent and edge for the initial room
+		int32 ParentNode = INDEX_NONE;
+		int32 Node = INDEX_NONE;
+		int32 Edge = INDEX_NONE;
+		// Rooms to connect by corridor, with their edge
+		TArray<TTuple<int32, int32, int32>> CycleEdges;
+		// Index of the first cycle edge of this step among all cycle edges of the plan
+		int32 FirstCycleEdge = 0;
+	};
+	/**
+	 * @brief Undo record of one change made to rooms or corridors during generation,
+	 * occupancy writes are journaled by the grid itself
+	 */
+	struct FJournalEntry
+	{
+		enum EType : uint8
+		{
+			RoomAdded,
+			CorridorAdded,
+			DoorAdded,
+			SegmentChanged,
+			ConnectionAdded
+		};
+		EType Type;
+		URoom* Room = nullptr;
+		// Connected room of ConnectionAdded
+		URoom* OtherRoom = nullptr;
+		int32 SegmentIndex = INDEX_NONE;
+		// Previous state of the segment for SegmentChanged
+		bool bWasUsed = false;
+		// Added door for DoorAdded, previous segment door for SegmentChanged
+		TTuple<FIntVector2, FIntVector2> Door;
+	};
+	// Journal positions to roll back to
+	struct FSavepoint
+	{
+		int32 JournalPosition = 0;
+		int32 OccupancyPosition = 0;
+	};
+	TArray<FJournalEntry> Journal;
+	// Attempts of a single step before an earlier step is undone as well
+	static constexpr int32 MaxStepAttempts = 3;
+
+	/**
+	 * @brief Orders room placements and cycle edges the way breadth first traversal from the initial node reaches them,
+	 * depends on the graph only so the plan is the same for every seed
+	 * @param InitialNode Node of the first room
+	 * @param OutSteps Placement steps, step index equals index of the room in AllRooms
+	 * @param OutNodeSteps Step placing the room of every node, INDEX_NONE for unreachable ones
+	 */
+	void BuildPlacementPlan(const int32 InitialNode, TArray<FPlacementStep>& OutSteps, TArray<int32>& OutNodeSteps) const;
+	/**
+	 * @brief Places room of the step and connects its cycle edges, each with its own derived random stream
+	 * @param Steps Placement plan
+	 * @param StepIndex Step to execute
+	 * @param Execution How many times the step was executed before, selects fresh streams for retries
+	 * @param NodeSteps Step placing the room of every node
+	 * @param OutFailedCycleEdge Cycle edge of the step whose corridor could not be found, INDEX_NONE when the room failed
+	 * @return True - step succeeded, False - some corridor could not be found, state has to be rolled back
+	 */
+	bool ExecuteStep(const TArray<FPlacementStep>& Steps, const int32 StepIndex, const uint32 Execution,
+		const TArray<int32>& NodeSteps, int32& OutFailedCycleEdge);
+	FSavepoint MakeSavepoint() const;
+	/**
+	 * @brief Undoes every journaled change made after the savepoint, in time proportional to the undone work
+	 * @param Savepoint Savepoint taken earlier in the same generation
+	 */
+	void RollbackTo(const FSavepoint& Savepoint);
+	// Journaled state changes, generation modifies existing rooms only through these
+	URoom* AddRoom();
+	void UseSegment(URoom* Room, URoomSegment& Segment, const TTuple<FIntVector2, FIntVector2>& Door);
+	void Connect(URoom* Room, URoom* OtherRoom);
+
+	/**
+	 * @brief Creates new room and connects it to its parent room
+	 * @param ParentRoom Parent room
+	 * @param ChildRoomNode Child room to be created
+	 * @param Edge Corresponding graph edge between parent and child rooms
+	 * @return Newly created room
+	 */
+	URoom* ConnectWithNew(URoom* ParentRoom, const FDungeonLayoutInput::FNode& ChildRoomNode, const FDungeonLayoutInput::FEdge& Edge);
+	/**
+	 * @brief Connects two already existing rooms with corridor
+	 * @param ParentRoom Parent room to be connected from
+	 * @param ChildRoomNode Child room to be connected to
+	 * @param Edge Corresponding graph edge between parent and child rooms
+	 * @return Newly created room
+	 */
+	bool ConnectWithExisting(URoom* ParentRoom, URoom* ChildRoom, const FDungeonLayoutInput::FEdge& Edge);
+
+	/**
+	 * @brief Lists every free origin of the room in rings of growing distance from the parent side
+	 * and picks one at random from the nearest ring that has any, no placement attempt is rejected
+	 * @param ParentRoom Room the new room is placed next to
+	 * @param Direction Side of the parent room
+	 * @param MinDistance Distance of the first ring
+	 * @param Width Width of the new room
+	 * @param Height Height of the new room
+	 * @param OutOrigin Picked origin, valid only on success
+	 * @return True - free origin found within MaxPlacementRings rings, False - otherwise
+	 */
+	bool FindRoomOrigin(const URoom* ParentRoom, const EDirection Direction, const int32 MinDistance,
+		const int32 Width, const int32 Height, FIntVector2& OutOrigin);
+	// Rings searched by FindRoomOrigin before the side is given up
+	static constexpr int32 MaxPlacementRings = 256;
+	// Free origins of the current ring, reused by every FindRoomOrigin call
+	TArray<FIntVector2> OriginCandidates;
+
+	int32 SegmentLength(const TTuple<FIntVector2, FIntVector2> Segment);
+	bool IsOccupied(const FIntVector2 Coords, const int32 Width, const int32 Height);
+	void InsertOccupiedTiles(URoom* Room);
+
+	/**
+	 * @brief A* path finding algorithm with Manhattan distance metrics and binary heap open list,
+	 * only searches, the found corridor is applied by CommitCorridor
+	 * @param Source door
+	 * @param Finish door
+	 * @param SourceRoom object
+	 * @param FinishRoom object
+	 * @param OutCorridor found corridor, valid only on success
+	 * @param PendingRoom room not yet inserted into occupied tiles whose walls are treated as occupied
+	 * @return True - path found within maximum corridor length, False - otherwise
+	 */
+	bool FindAWay(
+		const TTuple<FIntVector2, FIntVector2>& Source,
+		const TTuple<FIntVector2, FIntVector2>& Finish,
+		const URoom* SourceRoom, const URoom* FinishRoom, UCorridor& OutCorridor,
+		const URoom* PendingRoom = nullptr);
+	/**
+	 * @brief Single A* search seeded from all source doors at once, stops at the first finish door reached
+	 * @param Sources candidate source doors of the same width
+	 * @param Finishes candidate finish doors
+	 * @param SourceRoom object
+	 * @param FinishRoom object
+	 * @param OutCorridor found corridor, valid only on success
+	 * @param OutSourceIndex index of the source door the path starts from
+	 * @param OutFinishIndex index of the finish door the path ends at
+	 * @param PendingRoom room not yet inserted into occupied tiles whose walls are treated as occupied
+	 * @return True - path found within maximum corridor length, False - otherwise
+	 */
+	bool FindAWay(
+		TArrayView<const TTuple<FIntVector2, FIntVector2>> Sources,
+		TArrayView<const TTuple<FIntVector2, FIntVector2>> Finishes,
+		const URoom* SourceRoom, const URoom* FinishRoom, UCorridor& OutCorridor,
+		int32& OutSourceIndex, int32& OutFinishIndex,
+		const URoom* PendingRoom = nullptr);
+	/**
+	 * @brief Stores corridor found by FindAWay and marks its tiles as occupied, both journaled
+	 * @param Corridor Corridor to be stored, moved from
+	 * @param Edge Corresponding graph edge
+	 */
+	void CommitCorridor(UCorridor& Corridor, const FDungeonLayoutInput::FEdge& Edge);
+	bool IsSquareBlocked(const FIntVector2 Origin, const int32 Size, const URoom* PendingRoom) const;
+};
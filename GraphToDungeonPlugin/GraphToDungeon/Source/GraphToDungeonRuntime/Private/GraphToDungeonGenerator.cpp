@@ -0,0 +1,553 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+
+#include "GraphToDungeonGenerator.h"
+#include "DerivedSeed.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Engine/InstancedStaticMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerStart.h"
+
+// Sets default values
+AGraphToDungeonGenerator::AGraphToDungeonGenerator()
+{
+	tileSize = FVector(100, 100, 0);
+
+	GeneratorRootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Generator Root"));
+	SetRootComponent(GeneratorRootComponent);
+	RootComponent->SetMobility(EComponentMobility::Movable);
+
+	auto SetupAttachmentToRoot = [&](USceneComponent* Component) -> void
+		{
+			Component->SetMobility(EComponentMobility::Movable);
+			Component->SetRelativeLocation(FVector());
+			Component->SetupAttachment(RootComponent);
+			Component->RegisterComponent();
+		};
+
+ 	// Ticks only while time sliced spawning is in progress
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+}
+
+// Called when the game starts or when spawned
+void AGraphToDungeonGenerator::BeginPlay()
+{
+	UE_LOG(LogTemp, Warning, TEXT("BeginPlay"));
+	Super::BeginPlay();
+}
+
+// Called every frame
+void AGraphToDungeonGenerator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (IsSpawning()) SpawnQueuedUnits();
+}
+
+void AGraphToDungeonGenerator::Destroyed()
+{
+	OnGeneratorDeleted.ExecuteIfBound();
+}
+
+void AGraphToDungeonGenerator::GenerateMesh(FComponentVariants& OutputVariants, const TMap<FString, TArray<FMeshWithProbability>*>& MeshCategories, const FString& Name)
+{
+	// If no local theme mesh found, global mesh is used in place
+	if (MeshCategories[Name]->Num() == 0)
+	{
+		GenerateMesh(OutputVariants, Properties->GlobalLevelTheme->MeshCategories, Name);
+		return;
+	}
+
+	TArray<FComponentWithProbability>& Variants = OutputVariants.Variants;
+	for (const auto& Theme : (*MeshCategories[Name]))
+	{
+		const int32 ArrayIndex = Variants.AddDefaulted();
+		Variants[ArrayIndex].Probability = Theme.Mesh ? Theme.Probability : (*Properties->GlobalLevelTheme->MeshCategories[Name])[0].Probability;
+		Variants[ArrayIndex].Mesh = Theme.Mesh ? Theme.Mesh : (*Properties->GlobalLevelTheme->MeshCategories[Name])[0].Mesh;
+	}
+	TArray<float, TInlineAllocator<16>> Weights;
+	for (const auto& Variant : Variants)
+	{
+		Weights.Add(Variant.Probability);
+	}
+	OutputVariants.Sampler.Build(Weights);
+}
+
+void AGraphToDungeonGenerator::GenerateRoomThemeMeshes(UGraphToDungeonTheme* LevelTheme)
+{
+	GenerateMesh(
+		GeneratedRoomThemes[LevelTheme].RoomFloorTiles,
+		LevelTheme->MeshCategories,
+		FString("Floors")
+	);
+	GenerateMesh(
+		GeneratedRoomThemes[LevelTheme].RoomWallTiles,
+		LevelTheme->MeshCategories,
+		FString("Walls")
+	);
+	GenerateMesh(
+		GeneratedRoomThemes[LevelTheme].RoomWallCornerTiles,
+		LevelTheme->MeshCategories,
+		FString("OutsideWallCorners")
+	);
+	GenerateMesh(
+		GeneratedRoomThemes[LevelTheme].RoomDoorTiles,
+		LevelTheme->MeshCategories,
+		FString("Doors")
+	);
+	GenerateMesh(
+		GeneratedRoomThemes[LevelTheme].RoomDoorLeftFrameTiles,
+		LevelTheme->MeshCategories,
+		FString("DoorFrameLeft")
+	);
+	GenerateMesh(
+		GeneratedRoomThemes[LevelTheme].RoomDoorRightFrameTiles,
+		LevelTheme->MeshCategories,
+		FString("DoorFrameRight")
+	);
+}
+
+void AGraphToDungeonGenerator::GenerateCorridorThemeMeshes(UGraphToDungeonTheme* LevelTheme)
+{
+	GenerateMesh(
+		GeneratedCorridorThemes[LevelTheme].CorridorFloorTiles,
+		LevelTheme->MeshCategories,
+		FString("Floors")
+	);
+	GenerateMesh(
+		GeneratedCorridorThemes[LevelTheme].CorridorWallTiles,
+		LevelTheme->MeshCategories,
+		FString("Walls")
+	);
+	GenerateMesh(
+		GeneratedCorridorThemes[LevelTheme].CorridorWallOutsideCornerTiles,
+		LevelTheme->MeshCategories,
+		FString("OutsideWallCorners")
+	);
+	GenerateMesh(
+		GeneratedCorridorThemes[LevelTheme].CorridorWallInsideCornerTiles,
+		LevelTheme->MeshCategories,
+		FString("InsideWallCorners")
+	);
+}
+
+UInstancedStaticMeshComponent* AGraphToDungeonGenerator::FindOrCreateMeshComponent(UStaticMesh* Mesh, const FIntVector2 Chunk)
+{
+	const TPair<UStaticMesh*, FIntVector2> Key(Mesh, Chunk);
+	if (UInstancedStaticMeshComponent** Component = MeshComponents.Find(Key))
+	{
+		// Pooled component is kept unless the output mode changed since it was created
+		if ((*Component)->IsA<UHierarchicalInstancedStaticMeshComponent>() == Properties->bUseHierarchicalInstancing) return *Component;
+		DestroyPooledComponent(*Component);
+		MeshComponents.Remove(Key);
+	}
+	const TSubclassOf<UInstancedStaticMeshComponent> ComponentClass = Properties->bUseHierarchicalInstancing ?
+		UHierarchicalInstancedStaticMeshComponent::StaticClass() : UInstancedStaticMeshComponent::StaticClass();
+	UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(this, ComponentClass,
+		MakeUniqueObjectName(this, ComponentClass, Mesh ? Mesh->GetFName() : FName("Mesh")));
+	Component->SetStaticMesh(Mesh);
+	Component->SetRelativeLocation(FVector());
+	Component->RegisterComponent();
+	Component->AttachToComponent(RootComponent, FAttachmentTransformRules::SnapToTargetIncludingScale);
+	MeshComponents.Add(Key, Component);
+	PooledComponents.Add(Component);
+	return Component;
+}
+
+FIntVector2 AGraphToDungeonGenerator::GetTileChunk(const FDungeonTile& Tile) const
+{
+	if (!Properties->bUseHierarchicalInstancing) return FIntVector2(0, 0);
+	const int32 ChunkSize = FMath::Max(1, Properties->InstanceChunkSize);
+	auto FloorDivide = [ChunkSize](const int32 Value) { return Value >= 0 ? Value / ChunkSize : (Value - ChunkSize + 1) / ChunkSize; };
+	return FIntVector2(FloorDivide(Tile.Position.X), FloorDivide(Tile.Position.Y));
+}
+
+void AGraphToDungeonGenerator::DestroyPooledComponent(UInstancedStaticMeshComponent* Component)
+{
+	PooledComponents.RemoveSwap(Component);
+	ComponentInstanceTiles.Remove(Component);
+	Component->DestroyComponent();
+}
+
+void AGraphToDungeonGenerator::ReleaseUnusedComponents()
+{
+	for (auto It = MeshComponents.CreateIterator(); It; ++It)
+	{
+		if (It.Value()->GetInstanceCount() > 0) continue;
+		DestroyPooledComponent(It.Value());
+		It.RemoveCurrent();
+	}
+}
+
+void AGraphToDungeonGenerator::ResetThemes()
+{
+	GeneratedCorridorThemes.Empty();
+	GeneratedRoomThemes.Empty();
+	UGraphToDungeonTheme* LevelTheme = Properties->GlobalLevelTheme;
+	if (LevelTheme)
+	{
+		GeneratedRoomThemes.Add(LevelTheme);
+		GeneratedCorridorThemes.Add(LevelTheme);
+		GenerateRoomThemeMeshes(LevelTheme);
+		GenerateCorridorThemeMeshes(LevelTheme);
+	}
+}
+
+void AGraphToDungeonGenerator::MeshCleanup()
+{
+	ResetThemes();
+	// Components stay pooled, only their instance buffers are emptied
+	for (UInstancedStaticMeshComponent* Component : PooledComponents)
+	{
+		Component->ClearInstances();
+	}
+	TileInstances.Reset();
+	ComponentInstanceTiles.Reset();
+	SpawnQueue.Reset();
+	NextSpawnUnit = 0;
+	QueuedTileComponents.Reset();
+}
+
+void AGraphToDungeonGenerator::RegenerateTheme(const int32 NewThemeSeed)
+{
+	ThemeSeed = NewThemeSeed;
+	if (CanUpdateIncrementally())
+	{
+		UpdateChangedInstances();
+		return;
+	}
+	// Spawning cleans up first, pooled components are refilled in place
+	SpawnRooms();
+}
+
+bool AGraphToDungeonGenerator::CanUpdateIncrementally() const
+{
+	if (IsSpawning() || TileInstances.Num() == 0 || TileInstances.Num() != Layout.Tiles.Num()) return false;
+	for (const UInstancedStaticMeshComponent* Component : PooledComponents)
+	{
+		if (!IsValid(Component) || Component->IsA<UHierarchicalInstancedStaticMeshComponent>() != Properties->bUseHierarchicalInstancing) return false;
+	}
+	return true;
+}
+
+void AGraphToDungeonGenerator::UpdateChangedInstances()
+{
+	ResetThemes();
+	TArray<UInstancedStaticMeshComponent*> TileComponents;
+	PickTileComponents(TileComponents);
+
+	// Slots left by tiles moving elsewhere and tiles moving in, per component
+	struct FComponentChanges
+	{
+		TArray<int32> FreedSlots;
+		TArray<int32> IncomingTiles;
+	};
+	TMap<UInstancedStaticMeshComponent*, FComponentChanges> Changes;
+	int32 ChangedTileCount = 0;
+	for (int32 TileIndex = 0; TileIndex < TileComponents.Num(); TileIndex++)
+	{
+		const FTileInstance& Instance = TileInstances[TileIndex];
+		if (TileComponents[TileIndex] == Instance.Component) continue;
+		Changes.FindOrAdd(Instance.Component).FreedSlots.Add(Instance.InstanceIndex);
+		Changes.FindOrAdd(TileComponents[TileIndex]).IncomingTiles.Add(TileIndex);
+		ChangedTileCount++;
+	}
+
+	for (auto& Change : Changes)
+	{
+		UInstancedStaticMeshComponent* Component = Change.Key;
+		TArray<int32>& InstanceTiles = ComponentInstanceTiles.FindOrAdd(Component);
+		TArray<int32>& FreedSlots = Change.Value.FreedSlots;
+		const TArray<int32>& IncomingTiles = Change.Value.IncomingTiles;
+
+		// Incoming tiles take over freed slots in place
+		const int32 ReusedCount = FMath::Min(FreedSlots.Num(), IncomingTiles.Num());
+		for (int32 Index = 0; Index < ReusedCount; Index++)
+		{
+			const int32 Slot = FreedSlots[Index];
+			const int32 TileIndex = IncomingTiles[Index];
+			Component->UpdateInstanceTransform(Slot, GetTileTransform(Layout.Tiles[TileIndex]), false, false, true);
+			InstanceTiles[Slot] = TileIndex;
+			TileInstances[TileIndex] = { Component, Slot };
+		}
+
+		// The rest is appended in one call
+		if (IncomingTiles.Num() > ReusedCount)
+		{
+			TArray<FTransform> Transforms;
+			Transforms.Reserve(IncomingTiles.Num() - ReusedCount);
+			for (int32 Index = ReusedCount; Index < IncomingTiles.Num(); Index++)
+			{
+				const int32 TileIndex = IncomingTiles[Index];
+				Transforms.Add(GetTileTransform(Layout.Tiles[TileIndex]));
+				TileInstances[TileIndex] = { Component, InstanceTiles.Num() };
+				InstanceTiles.Add(TileIndex);
+			}
+			Component->AddInstances(Transforms, false);
+		}
+
+		// Remaining freed slots are removed highest first, the last instance moves into each hole
+		// so that only the removed index disappears and no other instance shifts
+		FreedSlots.RemoveAt(0, ReusedCount, false);
+		FreedSlots.Sort(TGreater<int32>());
+		for (const int32 Slot : FreedSlots)
+		{
+			const int32 LastSlot = InstanceTiles.Num() - 1;
+			if (Slot != LastSlot)
+			{
+				FTransform LastTransform;
+				Component->GetInstanceTransform(LastSlot, LastTransform);
+				Component->UpdateInstanceTransform(Slot, LastTransform, false, false, true);
+				const int32 MovedTile = InstanceTiles[LastSlot];
+				InstanceTiles[Slot] = MovedTile;
+				TileInstances[MovedTile].InstanceIndex = Slot;
+			}
+			Component->RemoveInstance(LastSlot);
+			InstanceTiles.Pop(false);
+		}
+		Component->MarkRenderStateDirty();
+	}
+
+	UpdateSpawnStats();
+	UE_LOG(LogTemp, Log, TEXT("Theme regenerated, %d of %d instances changed"), ChangedTileCount, Layout.Tiles.Num());
+}
+
+int32 AGraphToDungeonGenerator::GetRandomThemeIndex(const FComponentVariants& ComponentVariants)
+{
+	return ComponentVariants.Sampler.Sample(ThemeStream);
+}
+
+FComponentVariants& AGraphToDungeonGenerator::GetTileComponents(const FDungeonTile& Tile)
+{
+	// Global theme is resolved here rather than stored in the layout, so cached layouts follow theme changes
+	UGraphToDungeonTheme* LevelTheme = Tile.Theme ? Tile.Theme : Properties->GlobalLevelTheme;
+	if (Tile.IsRoomTile())
+	{
+		if (!GeneratedRoomThemes.Contains(LevelTheme))
+		{
+			GeneratedRoomThemes.Add(LevelTheme);
+			GenerateRoomThemeMeshes(LevelTheme);
+		}
+		FRoomMeshes& RoomMeshes = GeneratedRoomThemes[LevelTheme];
+		switch (Tile.Type)
+		{
+		case EDungeonTileType::RoomWall:
+			return RoomMeshes.RoomWallTiles;
+		case EDungeonTileType::RoomWallCorner:
+			return RoomMeshes.RoomWallCornerTiles;
+		case EDungeonTileType::RoomDoor:
+			return RoomMeshes.RoomDoorTiles;
+		case EDungeonTileType::RoomDoorLeftFrame:
+			return RoomMeshes.RoomDoorLeftFrameTiles;
+		case EDungeonTileType::RoomDoorRightFrame:
+			return RoomMeshes.RoomDoorRightFrameTiles;
+		default:
+			return RoomMeshes.RoomFloorTiles;
+		}
+	}
+	if (!GeneratedCorridorThemes.Contains(LevelTheme))
+	{
+		GeneratedCorridorThemes.Add(LevelTheme);
+		GenerateCorridorThemeMeshes(LevelTheme);
+	}
+	FCorridorMeshes& CorridorMeshes = GeneratedCorridorThemes[LevelTheme];
+	switch (Tile.Type)
+	{
+	case EDungeonTileType::CorridorWall:
+		return CorridorMeshes.CorridorWallTiles;
+	case EDungeonTileType::CorridorWallOutsideCorner:
+		return CorridorMeshes.CorridorWallOutsideCornerTiles;
+	case EDungeonTileType::CorridorWallInsideCorner:
+		return CorridorMeshes.CorridorWallInsideCornerTiles;
+	default:
+		return CorridorMeshes.CorridorFloorTiles;
+	}
+}
+
+FTransform AGraphToDungeonGenerator::GetTileTransform(const FDungeonTile& Tile) const
+{
+	const FVector Location = FVector(Tile.Position.X, Tile.Position.Y, 0) * tileSize;
+	// Floor tiles are never rotated
+	if (Tile.Type == EDungeonTileType::RoomFloor || Tile.Type == EDungeonTileType::CorridorFloor) return FTransform(Location);
+	return FTransform(FRotator(0, Tile.Yaw + GlobalTileRotation, 0), Location);
+}
+
+void AGraphToDungeonGenerator::PickTileComponents(TArray<UInstancedStaticMeshComponent*>& OutTileComponents)
+{
+	OutTileComponents.Reset(Layout.Tiles.Num());
+	// Same seed always picks the same variants, whatever was drawn before
+	ThemeStream.Initialize(FDerivedSeed::Get(ThemeSeed, FDerivedSeed::Theme, 0));
+	for (const FDungeonTile& Tile : Layout.Tiles)
+	{
+		const FComponentVariants& Components = GetTileComponents(Tile);
+		OutTileComponents.Add(FindOrCreateMeshComponent(
+			Components.Variants[GetRandomThemeIndex(Components)].Mesh, GetTileChunk(Tile)));
+	}
+}
+
+void AGraphToDungeonGenerator::UpdateSpawnStats()
+{
+	SpawnedComponentCount = 0;
+	SpawnedDrawCallCount = 0;
+	for (const auto& MeshComponent : MeshComponents)
+	{
+		if (!MeshComponent.Key.Key || MeshComponent.Value->GetInstanceCount() == 0) continue;
+		SpawnedComponentCount++;
+		SpawnedDrawCallCount += MeshComponent.Key.Key->GetNumSections(0);
+	}
+}
+
+void AGraphToDungeonGenerator::SpawnRooms()
+{
+	MeshCleanup();
+	// Pick mesh variants first, then submit all transforms of each component in a single call
+	TArray<UInstancedStaticMeshComponent*> TileComponents;
+	PickTileComponents(TileComponents);
+	if (Properties->bTimeSliceSpawning)
+	{
+		QueueSpawnUnits(MoveTemp(TileComponents));
+		return;
+	}
+	TMap<UInstancedStaticMeshComponent*, int32> InstanceCounts;
+	for (UInstancedStaticMeshComponent* Component : TileComponents)
+	{
+		InstanceCounts.FindOrAdd(Component)++;
+	}
+	TMap<UInstancedStaticMeshComponent*, TArray<FTransform>> InstanceTransforms;
+	InstanceTransforms.Reserve(InstanceCounts.Num());
+	for (const auto& InstanceCount : InstanceCounts)
+	{
+		InstanceTransforms.Add(InstanceCount.Key).Reserve(InstanceCount.Value);
+		ComponentInstanceTiles.Add(InstanceCount.Key).Reserve(InstanceCount.Value);
+	}
+	// Components were cleared, so instance indices follow the submitted order
+	TileInstances.SetNum(Layout.Tiles.Num());
+	for (int32 TileIndex = 0; TileIndex < Layout.Tiles.Num(); TileIndex++)
+	{
+		UInstancedStaticMeshComponent* Component = TileComponents[TileIndex];
+		TArray<int32>& InstanceTiles = ComponentInstanceTiles[Component];
+		TileInstances[TileIndex] = { Component, InstanceTiles.Num() };
+		InstanceTiles.Add(TileIndex);
+		InstanceTransforms[Component].Add(GetTileTransform(Layout.Tiles[TileIndex]));
+	}
+	for (const auto& Transforms : InstanceTransforms)
+	{
+		Transforms.Key->AddInstances(Transforms.Value, false);
+	}
+	FinishSpawning();
+}
+
+void AGraphToDungeonGenerator::QueueSpawnUnits(TArray<UInstancedStaticMeshComponent*>&& TileComponents)
+{
+	QueuedTileComponents = MoveTemp(TileComponents);
+	TileInstances.SetNum(Layout.Tiles.Num());
+	// Tiles lie in the actor plane, height of the focus does not change the order
+	FVector Focus = GetActorTransform().InverseTransformPosition(GetSpawnFocus());
+	Focus.Z = 0;
+	auto QueueUnit = [this, &Focus](const int32 FirstTile, const int32 TileCount)
+		{
+			if (TileCount == 0) return;
+			FBox Bounds(ForceInit);
+			for (int32 TileIndex = FirstTile; TileIndex < FirstTile + TileCount; TileIndex++)
+			{
+				Bounds += GetTileTransform(Layout.Tiles[TileIndex]).GetLocation();
+			}
+			SpawnQueue.Add({ FirstTile, TileCount, Bounds.ComputeSquaredDistanceToPoint(Focus) });
+		};
+	for (const FDungeonLayoutRoom& Room : Layout.Rooms) QueueUnit(Room.FirstTile, Room.TileCount);
+	for (const FDungeonLayoutCorridor& Corridor : Layout.Corridors) QueueUnit(Corridor.FirstTile, Corridor.TileCount);
+	SpawnQueue.StableSort([](const FSpawnUnit& A, const FSpawnUnit& B) { return A.DistanceSquared < B.DistanceSquared; });
+	NextSpawnUnit = 0;
+	SetActorTickEnabled(true);
+	// Nearest rooms appear right away instead of on the next tick
+	SpawnQueuedUnits();
+}
+
+void AGraphToDungeonGenerator::SpawnQueuedUnits()
+{
+	const double EndTime = FPlatformTime::Seconds() + Properties->SpawnFrameBudgetMs / 1000.0;
+	const int32 InstanceBudget = Properties->SpawnFrameBudgetInstances;
+	int32 SpawnedInstances = 0;
+	TMap<UInstancedStaticMeshComponent*, TArray<FTransform>> InstanceTransforms;
+	while (IsSpawning())
+	{
+		const FSpawnUnit& Unit = SpawnQueue[NextSpawnUnit];
+		if (SpawnedInstances > 0 && InstanceBudget > 0 && SpawnedInstances + Unit.TileCount > InstanceBudget) break;
+		NextSpawnUnit++;
+		// Components were cleared before queuing, so instance indices follow the spawned order
+		for (auto& Transforms : InstanceTransforms)
+		{
+			Transforms.Value.Reset();
+		}
+		for (int32 TileIndex = Unit.FirstTile; TileIndex < Unit.FirstTile + Unit.TileCount; TileIndex++)
+		{
+			UInstancedStaticMeshComponent* Component = QueuedTileComponents[TileIndex];
+			TArray<int32>& InstanceTiles = ComponentInstanceTiles.FindOrAdd(Component);
+			TileInstances[TileIndex] = { Component, InstanceTiles.Num() };
+			InstanceTiles.Add(TileIndex);
+			InstanceTransforms.FindOrAdd(Component).Add(GetTileTransform(Layout.Tiles[TileIndex]));
+		}
+		// One submission per component and unit
+		for (const auto& Transforms : InstanceTransforms)
+		{
+			if (Transforms.Value.Num() > 0) Transforms.Key->AddInstances(Transforms.Value, false);
+		}
+		SpawnedInstances += Unit.TileCount;
+		if (FPlatformTime::Seconds() >= EndTime) break;
+	}
+	if (!IsSpawning()) FinishSpawning();
+}
+
+void AGraphToDungeonGenerator::FinishSpawning()
+{
+	SetActorTickEnabled(false);
+	SpawnQueue.Reset();
+	NextSpawnUnit = 0;
+	QueuedTileComponents.Reset();
+	if (bReleaseUnusedComponents)
+	{
+		// Meshes and chunks of the previous layout may no longer be needed
+		ReleaseUnusedComponents();
+		bReleaseUnusedComponents = false;
+	}
+	UpdateSpawnStats();
+	UE_LOG(LogTemp, Log, TEXT("Spawned %d instances in %d components, %d draw calls"),
+		Layout.Tiles.Num(), SpawnedComponentCount, SpawnedDrawCallCount);
+	OnSpawningFinished.ExecuteIfBound();
+}
+
+FVector AGraphToDungeonGenerator::GetSpawnFocus() const
+{
+	if (SpawnFocus.IsSet()) return SpawnFocus.GetValue();
+	UWorld* World = GetWorld();
+	if (!World) return GetActorLocation();
+	if (APlayerController* PlayerController = World->GetFirstPlayerController())
+	{
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		return ViewLocation;
+	}
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		return It->GetActorLocation();
+	}
+	return GetActorLocation();
+}
+
+void AGraphToDungeonGenerator::SpawnLayout(UGraphToDungeonProperties* LevelProperties, FDungeonLayout&& NewLayout, const int32 NewThemeSeed,
+	const TOptional<FVector>& FocusLocation)
+{
+	ThemeSeed = NewThemeSeed;
+	Properties = LevelProperties;
+	GlobalTileRotation = Properties->RotateTiles;
+	tileSize = Properties->TileSize;
+	Layout = MoveTemp(NewLayout);
+	SpawnFocus = FocusLocation;
+	bReleaseUnusedComponents = true;
+	SpawnRooms();
+}
@@ -3,7 +3,9 @@
 
 #include "GraphToDungeonProperties.h"
 
+#if WITH_EDITOR
 void UGraphToDungeonProperties::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	OnPropertiesEdited.ExecuteIfBound();
 }
+#endif
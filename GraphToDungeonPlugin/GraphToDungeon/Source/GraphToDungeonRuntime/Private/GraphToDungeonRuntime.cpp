@@ -0,0 +1,5 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, GraphToDungeonRuntime)
@@ -2,6 +2,8 @@
 
 
 #include "GraphToDungeonTheme.h"
+#include "UObject/ConstructorHelpers.h"
+#include "Engine/StaticMesh.h"
 
 UGraphToDungeonTheme::UGraphToDungeonTheme()
 {
@@ -24,6 +26,7 @@ UGraphToDungeonTheme::~UGraphToDungeonTheme()
 {
 }
 
+#if WITH_EDITOR
 void UGraphToDungeonTheme::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
 	for (auto& Category : MeshCategories)
@@ -34,6 +37,7 @@ void UGraphToDungeonTheme::PostEditChangeProperty(FPropertyChangedEvent& Propert
 		}
 	}
 }
+#endif
 
 void UGraphToDungeonTheme::ComputeProbability(TArray<FMeshWithProbability>& Array)
 {
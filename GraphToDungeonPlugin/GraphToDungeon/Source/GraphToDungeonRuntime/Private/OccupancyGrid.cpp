@@ -0,0 +1,211 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+
+#include "OccupancyGrid.h"
+
+static_assert(FOccupancyGrid::ChunkSize == 64, "Chunk rows are stored in uint64 words");
+
+void FOccupancyGrid::Add(const FIntVector2 Tile)
+{
+	const int32 ChunkIndex = FindOrAddChunk(ToChunkCoords(Tile));
+	WriteRow(ChunkIndex, Tile.Y & (ChunkSize - 1), uint64(1) << (Tile.X & (ChunkSize - 1)));
+	Chunks[ChunkIndex].bSumsDirty = true;
+	InvalidateClearance(ToChunkCoords(Tile));
+}
+
+void FOccupancyGrid::AddRect(const FIntVector2 Origin, const int32 Width, const int32 Height)
+{
+	if (Width <= 0 || Height <= 0) return;
+	const FIntVector2 Last(Origin.X + Width - 1, Origin.Y + Height - 1);
+	const FIntVector2 FirstChunk = ToChunkCoords(Origin);
+	const FIntVector2 LastChunk = ToChunkCoords(Last);
+	for (int32 ChunkY = FirstChunk.Y; ChunkY <= LastChunk.Y; ChunkY++)
+	{
+		const int32 FromY = ChunkY == FirstChunk.Y ? Origin.Y & (ChunkSize - 1) : 0;
+		const int32 ToY = ChunkY == LastChunk.Y ? Last.Y & (ChunkSize - 1) : ChunkSize - 1;
+		for (int32 ChunkX = FirstChunk.X; ChunkX <= LastChunk.X; ChunkX++)
+		{
+			const int32 FromX = ChunkX == FirstChunk.X ? Origin.X & (ChunkSize - 1) : 0;
+			const int32 ToX = ChunkX == LastChunk.X ? Last.X & (ChunkSize - 1) : ChunkSize - 1;
+			const uint64 Mask = RowMask(FromX, ToX);
+			const int32 ChunkIndex = FindOrAddChunk(FIntVector2(ChunkX, ChunkY));
+			for (int32 Row = FromY; Row <= ToY; Row++)
+			{
+				WriteRow(ChunkIndex, Row, Mask);
+			}
+			Chunks[ChunkIndex].bSumsDirty = true;
+			InvalidateClearance(FIntVector2(ChunkX, ChunkY));
+		}
+	}
+}
+
+bool FOccupancyGrid::Contains(const FIntVector2 Tile) const
+{
+	const FChunk* Chunk = FindChunk(ToChunkCoords(Tile));
+	return Chunk && (Chunk->Rows[Tile.Y & (ChunkSize - 1)] >> (Tile.X & (ChunkSize - 1))) & 1;
+}
+
+bool FOccupancyGrid::IsRectOccupied(const FIntVector2 Origin, const int32 Width, const int32 Height) const
+{
+	if (Width <= 0 || Height <= 0) return false;
+	const FIntVector2 Last(Origin.X + Width - 1, Origin.Y + Height - 1);
+	const FIntVector2 FirstChunk = ToChunkCoords(Origin);
+	const FIntVector2 LastChunk = ToChunkCoords(Last);
+	for (int32 ChunkY = FirstChunk.Y; ChunkY <= LastChunk.Y; ChunkY++)
+	{
+		const int32 FromY = ChunkY == FirstChunk.Y ? Origin.Y & (ChunkSize - 1) : 0;
+		const int32 ToY = ChunkY == LastChunk.Y ? Last.Y & (ChunkSize - 1) : ChunkSize - 1;
+		for (int32 ChunkX = FirstChunk.X; ChunkX <= LastChunk.X; ChunkX++)
+		{
+			const FChunk* Chunk = FindChunk(FIntVector2(ChunkX, ChunkY));
+			if (!Chunk) continue;
+			const int32 FromX = ChunkX == FirstChunk.X ? Origin.X & (ChunkSize - 1) : 0;
+			const int32 ToX = ChunkX == LastChunk.X ? Last.X & (ChunkSize - 1) : ChunkSize - 1;
+			if (Chunk->bSumsDirty) Chunk->UpdateSums();
+			if (Chunk->CountRect(FromX, FromY, ToX, ToY) > 0) return true;
+		}
+	}
+	return false;
+}
+
+int32 FOccupancyGrid::GetClearance(const FIntVector2 Tile) const
+{
+	const FIntVector2 ChunkCoords = ToChunkCoords(Tile);
+	FClearanceChunk* Clearance = nullptr;
+	if (const int32* Index = ClearanceIndices.Find(ChunkCoords))
+	{
+		Clearance = &ClearanceChunks[*Index];
+	}
+	else
+	{
+		// Squares anchored in this chunk reach at most into the right, upper and upper right chunks
+		if (!FindChunk(ChunkCoords) && !FindChunk(ChunkCoords + FIntVector2(1, 0)) &&
+			!FindChunk(ChunkCoords + FIntVector2(0, 1)) && !FindChunk(ChunkCoords + FIntVector2(1, 1))) return MaxClearance;
+		const int32 NewIndex = ClearanceChunks.AddDefaulted();
+		ClearanceIndices.Add(ChunkCoords, NewIndex);
+		Clearance = &ClearanceChunks[NewIndex];
+	}
+	if (Clearance->bDirty) UpdateClearance(ChunkCoords, *Clearance);
+	return Clearance->Values[Tile.Y & (ChunkSize - 1)][Tile.X & (ChunkSize - 1)];
+}
+
+bool FOccupancyGrid::IsSquareOccupied(const FIntVector2 Origin, const int32 Size) const
+{
+	if (Size > MaxClearance) return IsRectOccupied(Origin, Size, Size);
+	return GetClearance(Origin) < Size;
+}
+
+void FOccupancyGrid::Empty()
+{
+	ChunkIndices.Empty();
+	Chunks.Empty();
+	ClearanceIndices.Empty();
+	ClearanceChunks.Empty();
+	Journal.Empty();
+}
+
+void FOccupancyGrid::RollbackTo(const int32 JournalPosition)
+{
+	int32 LastChunkIndex = INDEX_NONE;
+	while (Journal.Num() > JournalPosition)
+	{
+		const FRowWrite Write = Journal.Pop(false);
+		FChunk& Chunk = Chunks[Write.ChunkIndex];
+		Chunk.Rows[Write.Row] = Write.PreviousRow;
+		// Consecutive writes mostly hit the same chunk
+		if (Write.ChunkIndex == LastChunkIndex) continue;
+		LastChunkIndex = Write.ChunkIndex;
+		Chunk.bSumsDirty = true;
+		InvalidateClearance(Chunk.Coords);
+	}
+}
+
+const FOccupancyGrid::FChunk* FOccupancyGrid::FindChunk(const FIntVector2 ChunkCoords) const
+{
+	const int32* Index = ChunkIndices.Find(ChunkCoords);
+	return Index ? &Chunks[*Index] : nullptr;
+}
+
+int32 FOccupancyGrid::FindOrAddChunk(const FIntVector2 ChunkCoords)
+{
+	if (const int32* Index = ChunkIndices.Find(ChunkCoords)) return *Index;
+	const int32 Index = Chunks.AddDefaulted();
+	Chunks[Index].Coords = ChunkCoords;
+	ChunkIndices.Add(ChunkCoords, Index);
+	return Index;
+}
+
+void FOccupancyGrid::WriteRow(const int32 ChunkIndex, const int32 Row, const uint64 Mask)
+{
+	uint64& RowWord = Chunks[ChunkIndex].Rows[Row];
+	if ((RowWord & Mask) == Mask) return;
+	Journal.Add({ ChunkIndex, Row, RowWord });
+	RowWord |= Mask;
+}
+
+void FOccupancyGrid::InvalidateClearance(const FIntVector2 ChunkCoords)
+{
+	for (const FIntVector2 Offset : { FIntVector2(0, 0), FIntVector2(-1, 0), FIntVector2(0, -1), FIntVector2(-1, -1) })
+	{
+		if (const int32* Index = ClearanceIndices.Find(ChunkCoords + Offset)) ClearanceChunks[*Index].bDirty = true;
+	}
+}
+
+void FOccupancyGrid::UpdateClearance(const FIntVector2 ChunkCoords, FClearanceChunk& Clearance) const
+{
+	// Window of 2x2 chunks starting at this one, tiles past the window count as fully clear.
+	// That is exact because saturated squares never leave the window
+	constexpr int32 WindowSize = ChunkSize * 2;
+	const FChunk* WindowChunks[2][2];
+	for (int32 Y = 0; Y < 2; Y++)
+	{
+		for (int32 X = 0; X < 2; X++)
+		{
+			WindowChunks[Y][X] = FindChunk(ChunkCoords + FIntVector2(X, Y));
+		}
+	}
+	uint8 Window[WindowSize + 1][WindowSize + 1];
+	for (int32 Index = 0; Index <= WindowSize; Index++)
+	{
+		Window[WindowSize][Index] = (uint8)MaxClearance;
+		Window[Index][WindowSize] = (uint8)MaxClearance;
+	}
+	for (int32 Y = WindowSize - 1; Y >= 0; Y--)
+	{
+		for (int32 X = WindowSize - 1; X >= 0; X--)
+		{
+			const FChunk* Chunk = WindowChunks[Y / ChunkSize][X / ChunkSize];
+			if (Chunk && (Chunk->Rows[Y & (ChunkSize - 1)] >> (X & (ChunkSize - 1))) & 1)
+			{
+				Window[Y][X] = 0;
+				continue;
+			}
+			const int32 Smallest = FMath::Min(Window[Y][X + 1], FMath::Min(Window[Y + 1][X], Window[Y + 1][X + 1]));
+			Window[Y][X] = (uint8)FMath::Min(MaxClearance, Smallest + 1);
+		}
+	}
+	for (int32 Y = 0; Y < ChunkSize; Y++)
+	{
+		FMemory::Memcpy(Clearance.Values[Y], Window[Y], ChunkSize);
+	}
+	Clearance.bDirty = false;
+}
+
+void FOccupancyGrid::FChunk::UpdateSums() const
+{
+	for (int32 Y = 0; Y < ChunkSize; Y++)
+	{
+		int32 RowCount = 0;
+		for (int32 X = 0; X < ChunkSize; X++)
+		{
+			RowCount += (Rows[Y] >> X) & 1;
+			Sums[Y + 1][X + 1] = Sums[Y][X + 1] + RowCount;
+		}
+	}
+	bSumsDirty = false;
+}
+
+int32 FOccupancyGrid::FChunk::CountRect(const int32 FromX, const int32 FromY, const int32 ToX, const int32 ToY) const
+{
+	return Sums[ToY + 1][ToX + 1] - Sums[FromY][ToX + 1] - Sums[ToY + 1][FromX] + Sums[FromY][FromX];
+}
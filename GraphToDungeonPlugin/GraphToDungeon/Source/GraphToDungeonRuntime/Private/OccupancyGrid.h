@@ -0,0 +1,146 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief Sparse tile occupancy made of fixed-size square chunks,
+ * every chunk row is stored as one 64-bit word so rectangles are set word by word.
+ * Each chunk also keeps a summed-area table, rebuilt lazily after writes,
+ * so rectangle tests cost four lookups per touched chunk regardless of the rectangle size.
+ * Clearance, the largest free square anchored at a tile, is cached per chunk
+ * and recomputed only for chunks whose neighbourhood was written to.
+ * Every changed row word is journaled, so writes can be undone back to any earlier journal position
+ */
+class FOccupancyGrid
+{
+public:
+	// Edge length of one chunk in tiles, equal to the number of bits in a row word
+	static constexpr int32 ChunkSize = 64;
+	// Clearance values are saturated at this size
+	static constexpr int32 MaxClearance = ChunkSize;
+
+	/**
+	 * @brief Marks single tile as occupied
+	 * @param Tile Tile coordinates
+	 */
+	void Add(const FIntVector2 Tile);
+
+	/**
+	 * @brief Marks all tiles of the rectangle as occupied
+	 * @param Origin Bottom left tile of the rectangle
+	 * @param Width Size of the rectangle along X axis
+	 * @param Height Size of the rectangle along Y axis
+	 */
+	void AddRect(const FIntVector2 Origin, const int32 Width, const int32 Height);
+
+	/**
+	 * @brief Checks single tile
+	 * @param Tile Tile coordinates
+	 * @return True - tile is occupied, False - otherwise
+	 */
+	bool Contains(const FIntVector2 Tile) const;
+
+	/**
+	 * @brief Checks whether any tile of the rectangle is occupied
+	 * @param Origin Bottom left tile of the rectangle
+	 * @param Width Size of the rectangle along X axis
+	 * @param Height Size of the rectangle along Y axis
+	 * @return True - at least one tile is occupied, False - otherwise
+	 */
+	bool IsRectOccupied(const FIntVector2 Origin, const int32 Width, const int32 Height) const;
+
+	/**
+	 * @brief Size of the largest free square whose bottom left tile is the given tile
+	 * @param Tile Tile coordinates
+	 * @return Square edge length, 0 for occupied tile, at most MaxClearance
+	 */
+	int32 GetClearance(const FIntVector2 Tile) const;
+
+	/**
+	 * @brief Checks whether any tile of the square is occupied, single clearance lookup for sizes up to MaxClearance
+	 * @param Origin Bottom left tile of the square
+	 * @param Size Edge length of the square
+	 * @return True - at least one tile is occupied, False - otherwise
+	 */
+	bool IsSquareOccupied(const FIntVector2 Origin, const int32 Size) const;
+
+	/**
+	 * @brief Removes all chunks and the journal
+	 */
+	void Empty();
+
+	/**
+	 * @brief Current journal position, to be passed to RollbackTo
+	 * @return Number of journaled row writes
+	 */
+	int32 GetJournalPosition() const { return Journal.Num(); }
+
+	/**
+	 * @brief Undoes all writes made after the journal position, costs one step per changed row word
+	 * @param JournalPosition Position returned by GetJournalPosition
+	 */
+	void RollbackTo(const int32 JournalPosition);
+
+private:
+	struct FChunk
+	{
+		uint64 Rows[ChunkSize] = {};
+		// Number of occupied tiles in rows [0, Y) and columns [0, X), indexed [Y][X]
+		mutable uint16 Sums[ChunkSize + 1][ChunkSize + 1] = {};
+		mutable bool bSumsDirty = false;
+		FIntVector2 Coords;
+
+		// Recomputes summed-area table from row words
+		void UpdateSums() const;
+		// Occupied tile count in local rectangle, bounds inclusive
+		int32 CountRect(const int32 FromX, const int32 FromY, const int32 ToX, const int32 ToY) const;
+	};
+
+	// Chunk containing the tile, rounds towards negative infinity
+	static FIntVector2 ToChunkCoords(const FIntVector2 Tile)
+	{
+		return FIntVector2(Tile.X >> 6, Tile.Y >> 6);
+	}
+
+	// Word mask with bits From..To (inclusive) set
+	static uint64 RowMask(const int32 From, const int32 To)
+	{
+		return (~uint64(0) >> (ChunkSize - 1 - (To - From))) << From;
+	}
+
+	struct FClearanceChunk
+	{
+		// Clearance of every chunk tile, indexed [Y][X]
+		uint8 Values[ChunkSize][ChunkSize];
+		bool bDirty = true;
+	};
+
+	// Row word as it was before a write
+	struct FRowWrite
+	{
+		int32 ChunkIndex;
+		int32 Row;
+		uint64 PreviousRow;
+	};
+
+	const FChunk* FindChunk(const FIntVector2 ChunkCoords) const;
+	// Index of the chunk in Chunks, chunk is created when missing
+	int32 FindOrAddChunk(const FIntVector2 ChunkCoords);
+	// Sets mask bits of the row and journals the previous word if it changed
+	void WriteRow(const int32 ChunkIndex, const int32 Row, const uint64 Mask);
+
+	// Marks clearance of chunks depending on the written chunk for recomputation
+	void InvalidateClearance(const FIntVector2 ChunkCoords);
+	// Recomputes clearance of one chunk from its own occupancy and its upper and right neighbours
+	void UpdateClearance(const FIntVector2 ChunkCoords, FClearanceChunk& Clearance) const;
+
+	TMap<FIntVector2, int32> ChunkIndices;
+	TArray<FChunk> Chunks;
+	TArray<FRowWrite> Journal;
+
+	// Clearance chunks are created on first query, only where occupancy is nearby
+	mutable TMap<FIntVector2, int32> ClearanceIndices;
+	mutable TArray<FClearanceChunk> ClearanceChunks;
+};
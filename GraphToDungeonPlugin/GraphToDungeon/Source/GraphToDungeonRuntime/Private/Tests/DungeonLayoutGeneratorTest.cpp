@@ -0,0 +1,439 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+
+#include "Misc/AutomationTest.h"
+#include "DungeonLayoutGenerator.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Journaled operation of the generator, rooms are referred to by index so it can be replayed on another generator
+	struct FGeneratorOperation
+	{
+		enum EType : uint8
+		{
+			AddRoom,
+			UseSegment,
+			Connect,
+			CommitCorridor
+		};
+		EType Type;
+		int32 Room = 0;
+		int32 OtherRoom = 0;
+		int32 Segment = 0;
+		FIntVector2 Origin;
+		int32 Width = 0;
+		int32 Height = 0;
+		TTuple<FIntVector2, FIntVector2> Door;
+		TArray<FIntVector2> Squares;
+		TArray<FIntVector2> Points;
+	};
+
+	// Random operations valid for a generator holding RoomCount rooms, RoomCount is updated by the added rooms
+	TArray<FGeneratorOperation> MakeOperations(FRandomStream& Stream, int32& RoomCount, const int32 Count)
+	{
+		auto RandomTile = [&Stream]() { return FIntVector2(Stream.RandRange(-100, 100), Stream.RandRange(-100, 100)); };
+		TArray<FGeneratorOperation> Operations;
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			FGeneratorOperation& Operation = Operations.AddDefaulted_GetRef();
+			Operation.Type = RoomCount == 0 ? FGeneratorOperation::AddRoom : FGeneratorOperation::EType(Stream.RandRange(0, 3));
+			Operation.Room = Stream.RandRange(0, FMath::Max(0, RoomCount - 1));
+			Operation.OtherRoom = Stream.RandRange(0, FMath::Max(0, RoomCount - 1));
+			switch (Operation.Type)
+			{
+			case FGeneratorOperation::AddRoom:
+				Operation.Origin = RandomTile();
+				Operation.Width = Stream.RandRange(3, 20);
+				Operation.Height = Stream.RandRange(3, 20);
+				RoomCount++;
+				break;
+			case FGeneratorOperation::UseSegment:
+				Operation.Segment = Stream.RandRange(0, 3);
+				// Few distinct doors, so some of them are already in the door set
+				Operation.Door = MakeTuple(FIntVector2(Stream.RandRange(0, 3), 0), FIntVector2(Stream.RandRange(0, 3), 3));
+				break;
+			case FGeneratorOperation::Connect:
+				break;
+			case FGeneratorOperation::CommitCorridor:
+				Operation.Width = Stream.RandRange(1, 3);
+				for (int32 Square = Stream.RandRange(1, 10); Square > 0; Square--) Operation.Squares.Add(RandomTile());
+				for (int32 Point = Stream.RandRange(0, 3); Point > 0; Point--) Operation.Points.Add(RandomTile());
+				break;
+			}
+		}
+		return Operations;
+	}
+
+	using FTileClass = TPair<EDungeonTileType, int32>;
+
+	/**
+	 * @brief Set based corridor classification the bitmask tables of BuildLayout replaced, kept as the reference
+	 * @param Corridor Corridor to be classified
+	 * @return Type and yaw of every corridor tile
+	 */
+	TMap<FIntVector2, FTileClass> ClassifyCorridorReference(const FDungeonLayoutGenerator::UCorridor& Corridor)
+	{
+		enum EDirection { UP, DOWN, LEFT, RIGHT };
+		TMap<FIntVector2, FTileClass> Tiles;
+		TSet<FIntVector2> Path;
+		for (const auto& Square : Corridor.Squares)
+		{
+			for (int32 j = 0; j < Corridor.Width; j++)
+			{
+				for (int32 k = 0; k < Corridor.Width; k++)
+				{
+					Path.Add(FIntVector2(j + Square.X, k + Square.Y));
+				}
+			}
+			for (const auto& Point : Corridor.Points)
+			{
+				Path.Add(Point);
+			}
+		}
+		for (const auto& Point : Path) Tiles.Add(Point, FTileClass(EDungeonTileType::CorridorFloor, 0));
+
+		TMap<FIntVector2, EDirection> Border;
+		TMap<FIntVector2, TSet<EDirection>> OutsideBorder;
+		for (const auto& Point : Path)
+		{
+			if (Point != Corridor.StartBot && Point != Corridor.StartTop &&
+				Point != Corridor.EndBot && Point != Corridor.EndTop)
+			{
+				if (Corridor.StartBot.X == Corridor.StartTop.X && Point.X == Corridor.StartBot.X &&
+					Point.Y > Corridor.StartBot.Y && Point.Y < Corridor.StartTop.Y) continue;
+				if (Corridor.StartBot.Y == Corridor.StartTop.Y && Point.Y == Corridor.StartBot.Y &&
+					Point.X > Corridor.StartBot.X && Point.X < Corridor.StartTop.X) continue;
+				if (Corridor.EndBot.X == Corridor.EndTop.X && Point.X == Corridor.EndBot.X &&
+					Point.Y > Corridor.EndBot.Y && Point.Y < Corridor.EndTop.Y) continue;
+				if (Corridor.EndBot.Y == Corridor.EndTop.Y && Point.Y == Corridor.EndBot.Y &&
+					Point.X > Corridor.EndBot.X && Point.X < Corridor.EndTop.X) continue;
+			}
+			TSet<EDirection> TileDirections;
+			if (!Path.Contains(Point + FIntVector2(-1, 0))) TileDirections.Add(EDirection::LEFT);
+			if (!Path.Contains(Point + FIntVector2(+1, 0))) TileDirections.Add(EDirection::RIGHT);
+			if (!Path.Contains(Point + FIntVector2(0, -1))) TileDirections.Add(EDirection::DOWN);
+			if (!Path.Contains(Point + FIntVector2(0, +1))) TileDirections.Add(EDirection::UP);
+			if (TileDirections.Num() == 1) Border.Add(Point, TileDirections.Array()[0]);
+			if (TileDirections.Num() == 2) OutsideBorder.Add(Point, TileDirections);
+		}
+		TMap<FIntVector2, TSet<EDirection>> InsideBorder;
+		TSet<FIntVector2> BorderSet;
+		Border.GetKeys(BorderSet);
+		TSet<FIntVector2> OutsideBorderSet;
+		OutsideBorder.GetKeys(OutsideBorderSet);
+		const TSet<FIntVector2> AllBorderSet = BorderSet.Union(OutsideBorderSet);
+		for (const auto& Point : Path.Difference(AllBorderSet))
+		{
+			TSet<EDirection> TileDirections;
+			if (AllBorderSet.Contains(Point + FIntVector2(-1, 0))) TileDirections.Add(EDirection::LEFT);
+			if (AllBorderSet.Contains(Point + FIntVector2(+1, 0))) TileDirections.Add(EDirection::RIGHT);
+			if (AllBorderSet.Contains(Point + FIntVector2(0, -1))) TileDirections.Add(EDirection::DOWN);
+			if (AllBorderSet.Contains(Point + FIntVector2(0, +1))) TileDirections.Add(EDirection::UP);
+			if (TileDirections.Num() == 2 &&
+				(TileDirections.Contains(EDirection::LEFT) && TileDirections.Contains(EDirection::UP) ||
+				TileDirections.Contains(EDirection::RIGHT) && TileDirections.Contains(EDirection::UP) ||
+				TileDirections.Contains(EDirection::LEFT) && TileDirections.Contains(EDirection::DOWN) ||
+				TileDirections.Contains(EDirection::RIGHT) && TileDirections.Contains(EDirection::DOWN)))
+			{
+				if (!Path.Contains(Point + FIntVector2(+1, +1)) ||
+					!Path.Contains(Point + FIntVector2(+1, -1)) ||
+					!Path.Contains(Point + FIntVector2(-1, +1)) ||
+					!Path.Contains(Point + FIntVector2(-1, -1))) InsideBorder.Add(Point, TileDirections);
+			}
+		}
+		auto CornerYaw = [](const TSet<EDirection>& Directions) -> int32
+			{
+				int32 Yaw = 0;
+				if (Directions.Contains(EDirection::UP) && Directions.Contains(EDirection::LEFT)) Yaw = -90;
+				if (Directions.Contains(EDirection::UP) && Directions.Contains(EDirection::RIGHT)) Yaw = 180;
+				if (Directions.Contains(EDirection::DOWN) && Directions.Contains(EDirection::LEFT)) Yaw = 0;
+				if (Directions.Contains(EDirection::DOWN) && Directions.Contains(EDirection::RIGHT)) Yaw = 90;
+				return Yaw;
+			};
+		// Wall classes share one priority, a tile is in at most one of the maps, so they simply replace the floor
+		for (const auto& Point : Border)
+		{
+			const int32 WallYaw = Point.Value == EDirection::UP ? -90 : Point.Value == EDirection::DOWN ? 90 : Point.Value == EDirection::LEFT ? 0 : 180;
+			Tiles.Add(Point.Key, FTileClass(EDungeonTileType::CorridorWall, WallYaw));
+		}
+		for (const auto& Point : OutsideBorder)
+		{
+			Tiles.Add(Point.Key, FTileClass(EDungeonTileType::CorridorWallOutsideCorner, CornerYaw(Point.Value)));
+		}
+		for (const auto& Point : InsideBorder)
+		{
+			Tiles.Add(Point.Key, FTileClass(EDungeonTileType::CorridorWallInsideCorner, CornerYaw(Point.Value)));
+		}
+		return Tiles;
+	}
+
+	// Corridor shaped like a search result, a walk of squares with a few loose points and door frames at both ends
+	FDungeonLayoutGenerator::UCorridor MakeCorridor(FRandomStream& Stream)
+	{
+		FDungeonLayoutGenerator::UCorridor Corridor;
+		Corridor.Width = Stream.RandRange(1, 3);
+		FIntVector2 Square(0, 0);
+		for (int32 Step = Stream.RandRange(1, 40); Step > 0; Step--)
+		{
+			Corridor.Squares.Add(Square);
+			const int32 Direction = Stream.RandRange(0, 3);
+			Square += Direction == 0 ? FIntVector2(1, 0) : Direction == 1 ? FIntVector2(-1, 0) : Direction == 2 ? FIntVector2(0, 1) : FIntVector2(0, -1);
+		}
+		for (int32 Point = Stream.RandRange(0, 4); Point > 0; Point--)
+		{
+			const FIntVector2& Near = Corridor.Squares[Stream.RandRange(0, Corridor.Squares.Num() - 1)];
+			Corridor.Points.Add(Near + FIntVector2(Stream.RandRange(-1, Corridor.Width), Stream.RandRange(-1, Corridor.Width)));
+		}
+		// Door frames span the corridor width plus one tile on each side, vertical or horizontal
+		auto MakeDoor = [&Stream, &Corridor](const FIntVector2 At, FIntVector2& OutBot, FIntVector2& OutTop)
+			{
+				const bool bVertical = Stream.FRand() < 0.5f;
+				OutBot = At - (bVertical ? FIntVector2(0, 1) : FIntVector2(1, 0));
+				OutTop = At + (bVertical ? FIntVector2(0, Corridor.Width) : FIntVector2(Corridor.Width, 0));
+			};
+		MakeDoor(Corridor.Squares[0], Corridor.StartBot, Corridor.StartTop);
+		MakeDoor(Corridor.Squares.Last(), Corridor.EndBot, Corridor.EndTop);
+		return Corridor;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonLayoutGeneratorRollbackTest, "GraphToDungeon.DungeonLayoutGenerator.Rollback",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDungeonLayoutGeneratorRollbackTest::RunTest(const FString& Parameters)
+{
+	using URoom = FDungeonLayoutGenerator::URoom;
+	auto Apply = [](FDungeonLayoutGenerator& Generator, TConstArrayView<FGeneratorOperation> Operations)
+		{
+			for (const FGeneratorOperation& Operation : Operations)
+			{
+				switch (Operation.Type)
+				{
+				case FGeneratorOperation::AddRoom:
+				{
+					// Same order as room placement of the generation
+					URoom* Room = Generator.AddRoom();
+					Room->Origin = Operation.Origin;
+					Room->Width = Operation.Width;
+					Room->Height = Operation.Height;
+					Room->LocalTheme = nullptr;
+					Generator.InsertOccupiedTiles(Room);
+					break;
+				}
+				case FGeneratorOperation::UseSegment:
+				{
+					URoom* Room = Generator.AllRooms[Operation.Room];
+					Generator.UseSegment(Room, Room->Segments[Operation.Segment], Operation.Door);
+					break;
+				}
+				case FGeneratorOperation::Connect:
+					Generator.Connect(Generator.AllRooms[Operation.Room], Generator.AllRooms[Operation.OtherRoom]);
+					break;
+				case FGeneratorOperation::CommitCorridor:
+				{
+					FDungeonLayoutGenerator::UCorridor Corridor;
+					Corridor.Width = Operation.Width;
+					Corridor.Squares = Operation.Squares;
+					Corridor.Points = Operation.Points;
+					Generator.CommitCorridor(Corridor, FDungeonLayoutInput::FEdge());
+					break;
+				}
+				}
+			}
+		};
+	// Compares rooms, corridors and occupancy, stops at the first difference
+	auto Match = [this](const FDungeonLayoutGenerator& Generator, const FDungeonLayoutGenerator& Expected) -> bool
+		{
+			if (!TestEqual(TEXT("Room count"), Generator.AllRooms.Num(), Expected.AllRooms.Num()) ||
+				!TestEqual(TEXT("Corridor count"), Generator.AllCorridors.Num(), Expected.AllCorridors.Num())) return false;
+			for (int32 RoomIndex = 0; RoomIndex < Generator.AllRooms.Num(); RoomIndex++)
+			{
+				const URoom& Room = *Generator.AllRooms[RoomIndex];
+				const URoom& ExpectedRoom = *Expected.AllRooms[RoomIndex];
+				bool bSame = Room.Origin == ExpectedRoom.Origin && Room.Width == ExpectedRoom.Width && Room.Height == ExpectedRoom.Height &&
+					Room.Doors.Num() == ExpectedRoom.Doors.Num() && Room.Connections.Num() == ExpectedRoom.Connections.Num();
+				for (const auto& Door : ExpectedRoom.Doors) bSame &= Room.Doors.Contains(Door);
+				for (int32 Segment = 0; Segment < Room.Segments.Num(); Segment++)
+				{
+					bSame &= Room.Segments[Segment].bIsUsed == ExpectedRoom.Segments[Segment].bIsUsed &&
+						Room.Segments[Segment].Door == ExpectedRoom.Segments[Segment].Door;
+				}
+				for (URoom* Connection : ExpectedRoom.Connections)
+				{
+					bSame &= Room.Connections.Contains(Generator.AllRooms[Expected.AllRooms.Find(Connection)]);
+				}
+				if (!bSame)
+				{
+					AddError(FString::Printf(TEXT("Room %d differs"), RoomIndex));
+					return false;
+				}
+			}
+			for (int32 CorridorIndex = 0; CorridorIndex < Generator.AllCorridors.Num(); CorridorIndex++)
+			{
+				if (Generator.AllCorridors[CorridorIndex].Squares != Expected.AllCorridors[CorridorIndex].Squares ||
+					Generator.AllCorridors[CorridorIndex].Points != Expected.AllCorridors[CorridorIndex].Points)
+				{
+					AddError(FString::Printf(TEXT("Corridor %d differs"), CorridorIndex));
+					return false;
+				}
+			}
+			for (int32 Y = -200; Y < 200; Y++)
+			{
+				for (int32 X = -200; X < 200; X++)
+				{
+					const FIntVector2 Tile(X, Y);
+					if (Generator.OccupiedTiles.Contains(Tile) != Expected.OccupiedTiles.Contains(Tile) ||
+						Generator.OccupiedTiles.GetClearance(Tile) != Expected.OccupiedTiles.GetClearance(Tile) ||
+						Generator.OccupiedTiles.IsRectOccupied(Tile, 5, 3) != Expected.OccupiedTiles.IsRectOccupied(Tile, 5, 3))
+					{
+						AddError(FString::Printf(TEXT("Occupancy of tile (%d, %d) differs"), X, Y));
+						return false;
+					}
+				}
+			}
+			return true;
+		};
+
+	for (int32 Seed = 0; Seed < 8; Seed++)
+	{
+		FRandomStream Stream(Seed);
+		int32 RoomCount = 0;
+		const TArray<FGeneratorOperation> First = MakeOperations(Stream, RoomCount, 30);
+		const int32 FirstRoomCount = RoomCount;
+		const TArray<FGeneratorOperation> Second = MakeOperations(Stream, RoomCount, 30);
+		const int32 SecondRoomCount = RoomCount;
+		const TArray<FGeneratorOperation> Third = MakeOperations(Stream, RoomCount, 30);
+		// Retry of the last step with different operations, then undo of the step before it, as backtracking does
+		RoomCount = SecondRoomCount;
+		const TArray<FGeneratorOperation> Retry = MakeOperations(Stream, RoomCount, 30);
+
+		FDungeonLayoutGenerator Generator;
+		Apply(Generator, First);
+		const FDungeonLayoutGenerator::FSavepoint FirstSavepoint = Generator.MakeSavepoint();
+		Apply(Generator, Second);
+		const FDungeonLayoutGenerator::FSavepoint SecondSavepoint = Generator.MakeSavepoint();
+		Apply(Generator, Third);
+		Generator.RollbackTo(SecondSavepoint);
+		{
+			FDungeonLayoutGenerator Expected;
+			Apply(Expected, First);
+			Apply(Expected, Second);
+			if (!Match(Generator, Expected)) return false;
+		}
+		Apply(Generator, Retry);
+		{
+			FDungeonLayoutGenerator Expected;
+			Apply(Expected, First);
+			Apply(Expected, Second);
+			Apply(Expected, Retry);
+			if (!Match(Generator, Expected)) return false;
+		}
+		Generator.RollbackTo(FirstSavepoint);
+		{
+			FDungeonLayoutGenerator Expected;
+			Apply(Expected, First);
+			if (!TestEqual(TEXT("Room count at first savepoint"), Generator.AllRooms.Num(), FirstRoomCount) ||
+				!Match(Generator, Expected)) return false;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonLayoutMultiSourceSearchTest, "GraphToDungeon.DungeonLayoutGenerator.MultiSourceSearch",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDungeonLayoutMultiSourceSearchTest::RunTest(const FString& Parameters)
+{
+	using URoom = FDungeonLayoutGenerator::URoom;
+	FDungeonLayoutInput Input;
+	Input.MaxCorridorLength = 1000;
+	FDungeonLayoutGenerator Generator;
+	Generator.Input = &Input;
+
+	// Parent room with a door facing the child room and a door on its top wall
+	URoom Parent;
+	Parent.Origin = FIntVector2(0, 0);
+	Parent.Width = 10;
+	Parent.Height = 10;
+	URoom Child;
+	Child.Origin = FIntVector2(20, 0);
+	Child.Width = 10;
+	Child.Height = 10;
+	Generator.InsertOccupiedTiles(&Parent);
+	Generator.InsertOccupiedTiles(&Child);
+	// Nearest door pair is closed off by a dead end pocket in front of the facing door
+	Generator.OccupiedTiles.AddRect(FIntVector2(9, -4), 9, 1);
+	Generator.OccupiedTiles.AddRect(FIntVector2(9, 13), 9, 1);
+	Generator.OccupiedTiles.AddRect(FIntVector2(9, -4), 1, 18);
+	Generator.OccupiedTiles.AddRect(FIntVector2(17, -4), 1, 18);
+
+	const TTuple<FIntVector2, FIntVector2> ParentDoors[] = {
+		MakeTuple(FIntVector2(9, 4), FIntVector2(9, 5)),
+		MakeTuple(FIntVector2(4, 9), FIntVector2(5, 9)) };
+	const TTuple<FIntVector2, FIntVector2> ChildDoors[] = {
+		MakeTuple(FIntVector2(20, 4), FIntVector2(20, 5)) };
+	FDungeonLayoutGenerator::UCorridor Corridor;
+	int32 SourceIndex;
+	int32 FinishIndex;
+	if (!TestTrue(TEXT("Corridor found"), Generator.FindAWay(ParentDoors, ChildDoors, &Parent, &Child, Corridor, SourceIndex, FinishIndex))) return false;
+	TestEqual(TEXT("Source door"), SourceIndex, 1);
+	TestEqual(TEXT("Finish door"), FinishIndex, 0);
+	TestEqual(TEXT("Corridor start"), Corridor.StartBot, FIntVector2(4, 10));
+	TestEqual(TEXT("Corridor end"), Corridor.EndBot, FIntVector2(19, 4));
+
+	// Squares run from the finish back to the source door, each a free square one corridor width from the previous
+	if (!TestTrue(TEXT("Corridor has squares"), Corridor.Squares.Num() > 0)) return false;
+	TestEqual(TEXT("Square at the source door"), Corridor.Squares.Last(), FIntVector2(4, 10));
+	TestEqual(TEXT("Square at the finish door"), Corridor.Squares[0], FIntVector2(18, 4));
+	for (int32 SquareIndex = 0; SquareIndex < Corridor.Squares.Num(); SquareIndex++)
+	{
+		const FIntVector2 Square = Corridor.Squares[SquareIndex];
+		if (Generator.OccupiedTiles.IsSquareOccupied(Square, Corridor.Width))
+		{
+			AddError(FString::Printf(TEXT("Square (%d, %d) is occupied"), Square.X, Square.Y));
+			return false;
+		}
+		if (SquareIndex == 0) continue;
+		const FIntVector2 Step = Square - Corridor.Squares[SquareIndex - 1];
+		if (FMath::Abs(Step.X) + FMath::Abs(Step.Y) != Corridor.Width || (Step.X != 0 && Step.Y != 0))
+		{
+			AddError(FString::Printf(TEXT("Square (%d, %d) does not follow the previous one"), Square.X, Square.Y));
+			return false;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonLayoutCorridorClassificationTest, "GraphToDungeon.DungeonLayoutGenerator.CorridorClassification",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FDungeonLayoutCorridorClassificationTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Stream(0);
+	for (int32 CorridorIndex = 0; CorridorIndex < 500; CorridorIndex++)
+	{
+		FDungeonLayoutGenerator Generator;
+		Generator.AllCorridors.Add(MakeCorridor(Stream));
+		const TMap<FIntVector2, FTileClass> Expected = ClassifyCorridorReference(Generator.AllCorridors[0]);
+		FDungeonLayout Layout;
+		Generator.BuildLayout(Layout);
+
+		if (!TestEqual(TEXT("Tile count"), Layout.Tiles.Num(), Expected.Num())) return false;
+		for (const FDungeonTile& Tile : Layout.Tiles)
+		{
+			const FTileClass* ExpectedClass = Expected.Find(Tile.Position);
+			if (!ExpectedClass || ExpectedClass->Key != Tile.Type || ExpectedClass->Value != Tile.Yaw)
+			{
+				AddError(FString::Printf(TEXT("Corridor %d tile (%d, %d) has type %d yaw %d, expected type %d yaw %d"),
+					CorridorIndex, Tile.Position.X, Tile.Position.Y, int32(Tile.Type), Tile.Yaw,
+					ExpectedClass ? int32(ExpectedClass->Key) : -1, ExpectedClass ? ExpectedClass->Value : 0));
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
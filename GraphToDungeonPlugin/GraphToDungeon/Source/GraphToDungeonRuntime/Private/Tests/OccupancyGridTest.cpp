@@ -0,0 +1,128 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+
+#include "Misc/AutomationTest.h"
+#include "OccupancyGrid.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// Tiles of every write lie in [-Extent, Extent), so writes cross chunk borders and negative coordinates
+	constexpr int32 Extent = 150;
+	// Compared area reaches past the writes, where clearance depends on chunks that were never written
+	constexpr int32 CompareExtent = Extent + FOccupancyGrid::ChunkSize;
+
+	struct FGridWrite
+	{
+		FIntVector2 Origin;
+		int32 Width;
+		int32 Height;
+		bool bSingleTile;
+	};
+
+	TArray<FGridWrite> MakeWrites(FRandomStream& Stream, const int32 Count)
+	{
+		TArray<FGridWrite> Writes;
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			FGridWrite& Write = Writes.AddDefaulted_GetRef();
+			Write.Origin = FIntVector2(Stream.RandRange(-Extent, Extent - 1), Stream.RandRange(-Extent, Extent - 1));
+			Write.bSingleTile = Stream.FRand() < 0.3f;
+			Write.Width = Write.bSingleTile ? 1 : Stream.RandRange(1, FMath::Min(40, Extent - Write.Origin.X));
+			Write.Height = Write.bSingleTile ? 1 : Stream.RandRange(1, FMath::Min(40, Extent - Write.Origin.Y));
+		}
+		return Writes;
+	}
+
+	void ApplyWrites(FOccupancyGrid& Grid, TConstArrayView<FGridWrite> Writes)
+	{
+		for (const FGridWrite& Write : Writes)
+		{
+			if (Write.bSingleTile) Grid.Add(Write.Origin);
+			else Grid.AddRect(Write.Origin, Write.Width, Write.Height);
+		}
+	}
+
+	// Builds summed-area tables and clearance caches, so rollback has to invalidate them
+	void QueryAll(const FOccupancyGrid& Grid)
+	{
+		for (int32 Y = -CompareExtent; Y < CompareExtent; Y += 7)
+		{
+			for (int32 X = -CompareExtent; X < CompareExtent; X += 7)
+			{
+				Grid.GetClearance(FIntVector2(X, Y));
+				Grid.IsRectOccupied(FIntVector2(X, Y), 9, 9);
+			}
+		}
+	}
+
+	bool GridsMatch(FAutomationTestBase& Test, const FOccupancyGrid& Grid, const FOccupancyGrid& Expected, FRandomStream& Stream)
+	{
+		for (int32 Y = -CompareExtent; Y < CompareExtent; Y++)
+		{
+			for (int32 X = -CompareExtent; X < CompareExtent; X++)
+			{
+				const FIntVector2 Tile(X, Y);
+				if (Grid.Contains(Tile) != Expected.Contains(Tile) || Grid.GetClearance(Tile) != Expected.GetClearance(Tile))
+				{
+					Test.AddError(FString::Printf(TEXT("Tile (%d, %d) differs, clearance %d, expected %d"),
+						X, Y, Grid.GetClearance(Tile), Expected.GetClearance(Tile)));
+					return false;
+				}
+			}
+		}
+		for (int32 Index = 0; Index < 5000; Index++)
+		{
+			const FIntVector2 Origin(Stream.RandRange(-CompareExtent, CompareExtent), Stream.RandRange(-CompareExtent, CompareExtent));
+			const int32 Width = Stream.RandRange(1, 100);
+			const int32 Height = Stream.RandRange(1, 100);
+			if (Grid.IsRectOccupied(Origin, Width, Height) != Expected.IsRectOccupied(Origin, Width, Height))
+			{
+				Test.AddError(FString::Printf(TEXT("Rectangle (%d, %d) %dx%d differs"), Origin.X, Origin.Y, Width, Height));
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOccupancyGridRollbackTest, "GraphToDungeon.OccupancyGrid.Rollback",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FOccupancyGridRollbackTest::RunTest(const FString& Parameters)
+{
+	for (int32 Seed = 0; Seed < 8; Seed++)
+	{
+		FRandomStream Stream(Seed);
+		const TArray<FGridWrite> Writes = MakeWrites(Stream, 120);
+		const int32 SavedCount = Stream.RandRange(0, Writes.Num());
+
+		// Grid written past the savepoint and rolled back has to equal a grid written only up to it
+		FOccupancyGrid Grid;
+		ApplyWrites(Grid, MakeArrayView(Writes).Left(SavedCount));
+		QueryAll(Grid);
+		const int32 Savepoint = Grid.GetJournalPosition();
+		ApplyWrites(Grid, MakeArrayView(Writes).Mid(SavedCount));
+		QueryAll(Grid);
+		Grid.RollbackTo(Savepoint);
+		TestEqual(TEXT("Journal position after rollback"), Grid.GetJournalPosition(), Savepoint);
+
+		FOccupancyGrid Expected;
+		ApplyWrites(Expected, MakeArrayView(Writes).Left(SavedCount));
+		if (!GridsMatch(*this, Grid, Expected, Stream)) return false;
+
+		// Journal keeps working after a rollback
+		const TArray<FGridWrite> MoreWrites = MakeWrites(Stream, 40);
+		ApplyWrites(Grid, MoreWrites);
+		ApplyWrites(Expected, MoreWrites);
+		if (!GridsMatch(*this, Grid, Expected, Stream)) return false;
+
+		// Rollback to the very beginning leaves nothing occupied
+		Grid.RollbackTo(0);
+		if (!GridsMatch(*this, Grid, FOccupancyGrid(), Stream)) return false;
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,98 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief Walker alias table built with Vose's method, picks an index
+ * proportionally to its weight in constant time with a single random draw
+ */
+class FAliasTable
+{
+public:
+	/**
+	 * @brief Builds the table, weights do not have to be normalized
+	 * @param Weights Non-negative weight of every index
+	 */
+	void Build(TArrayView<const float> Weights)
+	{
+		const int32 Count = Weights.Num();
+		Probabilities.SetNumUninitialized(Count);
+		Aliases.SetNumUninitialized(Count);
+		if (Count == 0) return;
+
+		float WeightSum = 0.0f;
+		for (const float Weight : Weights)
+		{
+			WeightSum += FMath::Max(Weight, 0.0f);
+		}
+		if (WeightSum <= 0.0f)
+		{
+			// Nothing to weight by, always pick the last index
+			for (int32 Index = 0; Index < Count; Index++)
+			{
+				Probabilities[Index] = 0.0f;
+				Aliases[Index] = Count - 1;
+			}
+			return;
+		}
+
+		// Scaled so that the average column is exactly full
+		TArray<float, TInlineAllocator<16>> Scaled;
+		Scaled.SetNumUninitialized(Count);
+		TArray<int32, TInlineAllocator<16>> Small;
+		TArray<int32, TInlineAllocator<16>> Large;
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Scaled[Index] = FMath::Max(Weights[Index], 0.0f) * Count / WeightSum;
+			if (Scaled[Index] < 1.0f) Small.Add(Index);
+			else Large.Add(Index);
+		}
+		while (Small.Num() > 0 && Large.Num() > 0)
+		{
+			const int32 SmallIndex = Small.Pop(false);
+			const int32 LargeIndex = Large.Last();
+			Probabilities[SmallIndex] = Scaled[SmallIndex];
+			Aliases[SmallIndex] = LargeIndex;
+			Scaled[LargeIndex] -= 1.0f - Scaled[SmallIndex];
+			if (Scaled[LargeIndex] < 1.0f)
+			{
+				Large.Pop(false);
+				Small.Add(LargeIndex);
+			}
+		}
+		// Leftovers are full columns, up to rounding errors
+		for (const int32 Index : Large)
+		{
+			Probabilities[Index] = 1.0f;
+			Aliases[Index] = Index;
+		}
+		for (const int32 Index : Small)
+		{
+			Probabilities[Index] = 1.0f;
+			Aliases[Index] = Index;
+		}
+	}
+
+	/**
+	 * @brief Picks random index
+	 * @param RandomStream Stream the single draw is taken from
+	 * @return Picked index, INDEX_NONE for empty table
+	 */
+	int32 Sample(const FRandomStream& RandomStream) const
+	{
+		const int32 Count = Probabilities.Num();
+		if (Count == 0) return INDEX_NONE;
+		const float Column = RandomStream.GetFraction() * Count;
+		const int32 Index = FMath::Min(FMath::FloorToInt32(Column), Count - 1);
+		return Column - Index < Probabilities[Index] ? Index : Aliases[Index];
+	}
+
+	int32 Num() const { return Probabilities.Num(); }
+
+private:
+	// Chance of keeping the column index instead of its alias
+	TArray<float> Probabilities;
+	TArray<int32> Aliases;
+};
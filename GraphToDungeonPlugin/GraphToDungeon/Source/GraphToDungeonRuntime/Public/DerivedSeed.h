@@ -0,0 +1,48 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * @brief Counter-based derivation of independent stream seeds from one master seed.
+ * The seed depends only on its inputs, never on draws made elsewhere,
+ * so streams can be created in any order and on any thread with bit-identical results
+ */
+struct FDerivedSeed
+{
+	// Kind of stream, keeps streams of different stages apart for the same index
+	enum EDomain : uint32
+	{
+		Room = 1,
+		Edge = 2,
+		Theme = 3
+	};
+
+	/**
+	 * @brief Derives stream seed
+	 * @param MasterSeed Seed of the whole generation
+	 * @param Domain Kind of stream
+	 * @param Index Index of the room, edge or other item the stream belongs to
+	 * @param Counter Distinguishes repeated streams of the same item, e.g. retries
+	 * @return Seed to initialize FRandomStream with
+	 */
+	static int32 Get(const int32 MasterSeed, const EDomain Domain, const uint32 Index, const uint32 Counter = 0)
+	{
+		uint64 Hash = Mix((uint32)MasterSeed);
+		Hash = Mix(Hash ^ Domain);
+		Hash = Mix(Hash ^ Index);
+		Hash = Mix(Hash ^ Counter);
+		return (int32)(Hash >> 32);
+	}
+
+private:
+	// SplitMix64 step, every input bit affects every output bit
+	static uint64 Mix(uint64 Value)
+	{
+		Value += 0x9E3779B97F4A7C15ull;
+		Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+		return Value ^ (Value >> 31);
+	}
+};
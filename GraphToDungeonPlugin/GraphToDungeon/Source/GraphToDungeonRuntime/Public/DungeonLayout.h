@@ -0,0 +1,207 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+class ULevelGraphSession;
+class UGraphToDungeonProperties;
+class UGraphToDungeonTheme;
+
+/**
+ * @brief Kind of mesh a layout tile is drawn with
+ */
+enum class EDungeonTileType : uint8
+{
+	RoomFloor,
+	RoomWall,
+	RoomWallCorner,
+	RoomDoor,
+	RoomDoorLeftFrame,
+	RoomDoorRightFrame,
+	CorridorFloor,
+	CorridorWall,
+	CorridorWallOutsideCorner,
+	CorridorWallInsideCorner
+};
+
+/**
+ * @brief One classified tile of the layout
+ */
+struct FDungeonTile
+{
+	FIntVector2 Position;
+	EDungeonTileType Type = EDungeonTileType::RoomFloor;
+	// Yaw in degrees, without the global tile rotation of the properties
+	int32 Yaw = 0;
+	// Local theme of the owning room or corridor, null for the global theme of the properties used to spawn the layout
+	UGraphToDungeonTheme* Theme = nullptr;
+
+	bool IsRoomTile() const { return Type < EDungeonTileType::CorridorFloor; }
+
+	/**
+	 * @brief Priority of the tile when several emitters claim the same position
+	 * @return 2 - doors and door frames, 1 - walls and corners, 0 - floors
+	 */
+	int32 GetPriority() const
+	{
+		switch (Type)
+		{
+		case EDungeonTileType::RoomDoor:
+		case EDungeonTileType::RoomDoorLeftFrame:
+		case EDungeonTileType::RoomDoorRightFrame:
+			return 2;
+		case EDungeonTileType::RoomFloor:
+		case EDungeonTileType::CorridorFloor:
+			return 0;
+		default:
+			return 1;
+		}
+	}
+};
+
+/**
+ * @brief Room rectangle including its walls
+ */
+struct FDungeonLayoutRoom
+{
+	FIntVector2 Origin;
+	int32 Width = 0;
+	int32 Height = 0;
+	// First and last tile of every door in the room walls
+	TArray<TTuple<FIntVector2, FIntVector2>> Doors;
+	// Local theme, null for the global one
+	UGraphToDungeonTheme* Theme = nullptr;
+	// Layout tiles owned by this room, a shared position belongs to the room or corridor whose tile won it
+	int32 FirstTile = 0;
+	int32 TileCount = 0;
+};
+
+/**
+ * @brief Corridor as the set of its floor tiles
+ */
+struct FDungeonLayoutCorridor
+{
+	TArray<FIntVector2> Tiles;
+	int32 Width = 0;
+	// Local theme, null for the global one
+	UGraphToDungeonTheme* Theme = nullptr;
+	// Layout tiles owned by this corridor
+	int32 FirstTile = 0;
+	int32 TileCount = 0;
+};
+
+/**
+ * @brief Plain data copy of everything the generation reads from the level graph and properties.
+ * Taken on the game thread, generation then never touches the assets, so they may be edited meanwhile
+ */
+struct GRAPHTODUNGEONRUNTIME_API FDungeonLayoutInput
+{
+	struct FNeighbour
+	{
+		int32 Node = INDEX_NONE;
+		int32 Edge = INDEX_NONE;
+	};
+	struct FNode
+	{
+		int32 Width = 0;
+		int32 Height = 0;
+		UGraphToDungeonTheme* RoomTheme = nullptr;
+		// Children first, then parents, in graph order, which decides the placement order
+		TArray<FNeighbour> Neighbours;
+	};
+	struct FEdge
+	{
+		int32 Width = 0;
+		UGraphToDungeonTheme* CorridorTheme = nullptr;
+	};
+	// Nodes in the order of the graph, neighbours and edges refer to them by index
+	TArray<FNode> Nodes;
+	TArray<FEdge> Edges;
+	int32 MaxCorridorLength = 0;
+	int32 MaxBacktrackingSteps = 0;
+
+	/**
+	 * @brief Copies the graph and layout relevant properties, reads UObjects so game thread only
+	 * @param LevelGraph Graph to be laid out
+	 * @param LevelProperties Properties to be used
+	 * @return Generation input, without nodes for a missing graph
+	 */
+	static FDungeonLayoutInput Make(const ULevelGraphSession* LevelGraph, const UGraphToDungeonProperties* LevelProperties);
+};
+
+/**
+ * @brief Progress of running generations shared with other threads, safe to read and cancel from anywhere
+ */
+struct FDungeonLayoutProgress
+{
+	// Most rooms placed and corridors routed by any generation reporting here
+	std::atomic<int32> RoomsPlaced{ 0 };
+	std::atomic<int32> CorridorsRouted{ 0 };
+	// Once set, running generations stop and fail
+	std::atomic<bool> bCancelled{ false };
+
+	/**
+	 * @brief Raises the counters to the given state of one generation
+	 * @param Rooms Rooms placed by the generation
+	 * @param Corridors Corridors routed by the generation
+	 */
+	void Report(const int32 Rooms, const int32 Corridors)
+	{
+		for (int32 Placed = RoomsPlaced; Placed < Rooms && !RoomsPlaced.compare_exchange_weak(Placed, Rooms););
+		for (int32 Routed = CorridorsRouted; Routed < Corridors && !CorridorsRouted.compare_exchange_weak(Routed, Corridors););
+	}
+
+	void Reset()
+	{
+		RoomsPlaced = 0;
+		CorridorsRouted = 0;
+	}
+};
+
+/**
+ * @brief Plain data result of the layout generation, holds no actors or components
+ * and can be produced on any thread
+ */
+struct GRAPHTODUNGEONRUNTIME_API FDungeonLayout
+{
+	// Seed the layout was generated with
+	int32 Seed = 0;
+	TArray<FDungeonLayoutRoom> Rooms;
+	TArray<FDungeonLayoutCorridor> Corridors;
+	// Every mesh tile of the dungeon in spawn order, at most one per position
+	TArray<FDungeonTile> Tiles;
+
+	void Empty();
+
+	/**
+	 * @brief Saves or loads the layout, themes are stored as asset paths and loaded back, so game thread only
+	 * @param Ar Archive to serialize with
+	 * @return True - success, False - some theme of a loaded layout could not be resolved or the loaded data is invalid
+	 */
+	bool Serialize(FArchive& Ar);
+
+	/**
+	 * @brief Generates layout from a copy of the graph, touches no UObjects so it is safe to call from any thread
+	 * @param Input Graph and properties copied by FDungeonLayoutInput::Make
+	 * @param Seed Seed of the layout random stream
+	 * @param OutLayout Generated layout, valid only on success
+	 * @param Progress Optional progress to report to and to check for cancellation
+	 * @return True - successfull generation, False - otherwise or cancelled
+	 */
+	static bool Generate(const FDungeonLayoutInput& Input, const int32 Seed, FDungeonLayout& OutLayout,
+		FDungeonLayoutProgress* Progress = nullptr);
+
+	/**
+	 * @brief Generates layout of the level graph without spawning anything, the graph must not be edited meanwhile
+	 * @param LevelGraph Graph to be laid out
+	 * @param LevelProperties Properties to be used, only read
+	 * @param Seed Seed of the layout random stream
+	 * @param OutLayout Generated layout, valid only on success
+	 * @param Progress Optional progress to report to and to check for cancellation
+	 * @return True - successfull generation, False - otherwise or cancelled
+	 */
+	static bool Generate(const ULevelGraphSession* LevelGraph, const UGraphToDungeonProperties* LevelProperties,
+		const int32 Seed, FDungeonLayout& OutLayout, FDungeonLayoutProgress* Progress = nullptr);
+};
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FDungeonLayout;
+struct FDungeonLayoutInput;
+
+/**
+ * @brief On-disk cache of generated layouts under Saved/GraphToDungeon/LayoutCache.
+ * Entries are keyed by a content hash of the graph and the layout-relevant properties together with the seed,
+ * failed seeds are stored as well so that they are skipped without generating
+ */
+class GRAPHTODUNGEONRUNTIME_API FDungeonLayoutCache
+{
+public:
+	enum class EEntry : uint8
+	{
+		Missing,
+		Success,
+		Failure
+	};
+
+	/**
+	 * @brief Hashes everything the layout depends on except the seed, reads theme paths so game thread only
+	 * @param Input Copy of the graph and properties the layout is generated from
+	 * @return Hash of the generation inputs
+	 */
+	static uint64 HashInputs(const FDungeonLayoutInput& Input);
+
+	/**
+	 * @brief Looks the seed up, loads themes of a cached layout so game thread only
+	 * @param InputHash Hash returned by HashInputs
+	 * @param Seed Layout seed
+	 * @param OutLayout Cached layout, valid only for Success
+	 * @return Missing - not cached or unreadable, Success - layout loaded, Failure - seed is known to fail
+	 */
+	static EEntry Find(const uint64 InputHash, const int32 Seed, FDungeonLayout& OutLayout);
+
+	/**
+	 * @brief Stores generation result of the seed, then prunes the oldest entries past MaxEntries
+	 * @param InputHash Hash returned by HashInputs
+	 * @param Seed Layout seed
+	 * @param Layout Generated layout, null for a failed seed, only read
+	 */
+	static void Store(const uint64 InputHash, const int32 Seed, FDungeonLayout* Layout);
+
+private:
+	// Bumped whenever generation changes, so layouts of older versions are never used
+	static constexpr int32 Version = 6;
+	// Entries kept on disk, Store prunes the oldest ones past it
+	static constexpr int32 MaxEntries = 1024;
+
+	// Deletes the least recently written entries until at most MaxEntries are left
+	static void Prune();
+	static FString GetDirectory();
+	static FString GetEntryPath(const uint64 InputHash, const int32 Seed);
+};
@@ -11,7 +11,7 @@
  * @brief Represents graph edge as corridor, provides corridor properties
  */
 UCLASS(Blueprintable)
-class ULevelGraphEdge : public UGenericGraphEdge
+class GRAPHTODUNGEONRUNTIME_API ULevelGraphEdge : public UGenericGraphEdge
 {
 	GENERATED_BODY()
 public:
@@ -17,7 +17,7 @@ enum class EDialoguerPosition : uint8 {
  * @brief Class representing graph node as rooms, providing room properties
  */
 UCLASS(Blueprintable)
-class GRAPHTODUNGEONEDITOR_API ULevelGraphNode : public UGenericGraphNode
+class GRAPHTODUNGEONRUNTIME_API ULevelGraphNode : public UGenericGraphNode
 {
 	GENERATED_BODY()
 public:
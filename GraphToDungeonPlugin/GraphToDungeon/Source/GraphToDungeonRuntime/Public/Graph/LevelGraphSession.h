@@ -10,7 +10,7 @@
  * @brief Main graph class, inherits from UGenericGraph
  */
 UCLASS(Blueprintable)
-class GRAPHTODUNGEONEDITOR_API ULevelGraphSession : public UGenericGraph
+class GRAPHTODUNGEONRUNTIME_API ULevelGraphSession : public UGenericGraph
 {
 	GENERATED_BODY()
 public:
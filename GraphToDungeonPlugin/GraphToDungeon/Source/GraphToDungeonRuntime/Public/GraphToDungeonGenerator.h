@@ -0,0 +1,254 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "GraphToDungeonTheme.h"
+#include "GraphToDungeonProperties.h"
+#include "DungeonLayout.h"
+#include "AliasTable.h"
+#include "GraphToDungeonGenerator.generated.h"
+
+/**
+ * @brief Delegate invoked when this actor is deleted
+ */
+DECLARE_DELEGATE(FOnGeneratorDeleted)
+
+/**
+ * @brief Delegate invoked once all meshes of a spawn are in place, spawn stats are up to date by then
+ */
+DECLARE_DELEGATE(FOnSpawningFinished)
+
+/**
+ * @brief Structure representing one mesh variant with its probability,
+ * instances go to the pooled component of the mesh and tile chunk
+ */
+USTRUCT()
+struct FComponentWithProbability
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditDefaultsOnly)
+	UStaticMesh* Mesh = nullptr;
+	UPROPERTY(EditDefaultsOnly)
+	float Probability = 1.0f;
+};
+
+/**
+ * @brief All mesh variants of one tile category with a sampler picking among them
+ */
+USTRUCT()
+struct FComponentVariants
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditDefaultsOnly)
+	TArray<FComponentWithProbability> Variants;
+
+	// Built from variant probabilities once all variants are generated
+	FAliasTable Sampler;
+};
+
+/**
+ * @brief Structure encapsulating all room components
+ */
+USTRUCT()
+struct FRoomMeshes
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants RoomFloorTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants RoomWallTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants RoomWallCornerTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants RoomDoorTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants RoomDoorLeftFrameTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants RoomDoorRightFrameTiles;
+};
+
+/**
+ * @brief Structure encapsulating all corridor components
+ */
+USTRUCT()
+struct FCorridorMeshes
+{
+	GENERATED_BODY()
+public:
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants CorridorFloorTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants CorridorWallTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants CorridorWallOutsideCornerTiles;
+	UPROPERTY(EditDefaultsOnly)
+	FComponentVariants CorridorWallInsideCornerTiles;
+};
+
+/**
+ * @brief Actor performing dungeon generation and mesh instancing and storage inside a scene
+ */
+UCLASS()
+class GRAPHTODUNGEONRUNTIME_API AGraphToDungeonGenerator : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	// Sets default values for this actor's properties
+	AGraphToDungeonGenerator();
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+public:	
+	// Called every frame while time sliced spawning is in progress
+	virtual void Tick(float DeltaTime) override;
+	// Pending spawning continues in editor viewports too
+	virtual bool ShouldTickIfViewportsOnly() const override { return true; }
+
+private:
+	UGraphToDungeonProperties* Properties;
+
+	// Layout currently spawned in the world
+	FDungeonLayout Layout;
+	// Seed of the theme variant picks
+	int32 ThemeSeed = 0;
+	// Stream of the variant picks, derived from the theme seed at the start of every spawn
+	FRandomStream ThemeStream;
+public:
+	FOnGeneratorDeleted OnGeneratorDeleted;
+	FOnSpawningFinished OnSpawningFinished;
+
+	UPROPERTY(EditAnywhere)
+	FVector tileSize = FVector(100, 100, 0);
+
+	// Room Components
+	UPROPERTY(EditAnywhere, Category = "Generator")
+	TMap<UGraphToDungeonTheme*, FRoomMeshes> GeneratedRoomThemes;
+
+	UPROPERTY(EditAnywhere, Category = "Generator")
+	TMap<UGraphToDungeonTheme*, FCorridorMeshes> GeneratedCorridorThemes;
+
+	// All pooled components, keeps them referenced
+	UPROPERTY(VisibleAnywhere, Category = "Generator")
+	TArray<UInstancedStaticMeshComponent*> PooledComponents;
+
+	UPROPERTY(EditDefaultsOnly)
+	int32 GlobalTileRotation = 0;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Generator")
+	USceneComponent* GeneratorRootComponent;
+private:
+	virtual void Destroyed() override;
+
+	// Spawns meshes into the world, at once or queued for time sliced spawning
+	void SpawnRooms();
+	/**
+	 * @brief Queues every room and corridor of the layout, nearest to the spawn focus first
+	 * @param TileComponents Picked component of every layout tile
+	 */
+	void QueueSpawnUnits(TArray<UInstancedStaticMeshComponent*>&& TileComponents);
+	// Spawns queued rooms and corridors until the frame budget of the properties is used up
+	void SpawnQueuedUnits();
+	// Releases components and updates stats once all instances are spawned
+	void FinishSpawning();
+	// Location queued rooms and corridors are ordered by, the focus given to SpawnLayout,
+	// then the player view, the first player start and the actor itself
+	FVector GetSpawnFocus() const;
+	// Moves only tiles whose picked variant changed, the layout must be the one spawned last
+	void UpdateChangedInstances();
+	// True when every tile instance record still points to a live component of the current output mode
+	bool CanUpdateIncrementally() const;
+	// Picks variant component of every layout tile, in tile order
+	void PickTileComponents(TArray<UInstancedStaticMeshComponent*>& OutTileComponents);
+	// Forgets generated themes and generates the global one again
+	void ResetThemes();
+	void UpdateSpawnStats();
+
+	// Mesh spawning helper functions
+	void GenerateMesh(FComponentVariants& OutputVariants, const TMap<FString, TArray<FMeshWithProbability>*>& MeshCategories, const FString& Name);
+	void GenerateRoomThemeMeshes(UGraphToDungeonTheme* LevelTheme);
+	void GenerateCorridorThemeMeshes(UGraphToDungeonTheme* LevelTheme);
+	int32 GetRandomThemeIndex(const FComponentVariants& ComponentVariants);
+	// Mesh components of the tile theme and type, theme meshes are generated on first use
+	FComponentVariants& GetTileComponents(const FDungeonTile& Tile);
+	FTransform GetTileTransform(const FDungeonTile& Tile) const;
+	/**
+	 * @brief Returns pooled component of the mesh and chunk, creates it on first use
+	 * @param Mesh Static mesh of the component
+	 * @param Chunk Tile chunk coordinates, always zero when chunking is disabled
+	 * @return Instanced, or hierarchical instanced component when enabled in properties
+	 */
+	UInstancedStaticMeshComponent* FindOrCreateMeshComponent(UStaticMesh* Mesh, const FIntVector2 Chunk);
+	// Chunk of the tile when chunked hierarchical output is enabled, zero otherwise
+	FIntVector2 GetTileChunk(const FDungeonTile& Tile) const;
+	void DestroyPooledComponent(UInstancedStaticMeshComponent* Component);
+	// Destroys pooled components left without any instance
+	void ReleaseUnusedComponents();
+	// Forgets generated themes and clears instances of pooled components
+	void MeshCleanup();
+
+	// Components shared by every theme and category resolving to the same mesh, per tile chunk
+	TMap<TPair<UStaticMesh*, FIntVector2>, UInstancedStaticMeshComponent*> MeshComponents;
+
+	// Instance spawned for a layout tile
+	struct FTileInstance
+	{
+		UInstancedStaticMeshComponent* Component = nullptr;
+		int32 InstanceIndex = INDEX_NONE;
+	};
+	// Instance of every layout tile, in tile order
+	TArray<FTileInstance> TileInstances;
+	// Layout tile index of every instance, per component
+	TMap<UInstancedStaticMeshComponent*, TArray<int32>> ComponentInstanceTiles;
+
+	// Room or corridor waiting for time sliced spawning, as its range of layout tiles
+	struct FSpawnUnit
+	{
+		int32 FirstTile = 0;
+		int32 TileCount = 0;
+		double DistanceSquared = 0.0;
+	};
+	// Queued units sorted by distance, spawned from NextSpawnUnit on
+	TArray<FSpawnUnit> SpawnQueue;
+	int32 NextSpawnUnit = 0;
+	// Component picked for every layout tile, kept while the queue is spawned
+	TArray<UInstancedStaticMeshComponent*> QueuedTileComponents;
+	TOptional<FVector> SpawnFocus;
+	// Set by SpawnLayout, components of the previous layout are released once the new one is spawned
+	bool bReleaseUnusedComponents = false;
+
+	int32 SpawnedComponentCount = 0;
+	int32 SpawnedDrawCallCount = 0;
+public:
+	/**
+	 * @brief Spawns meshes of an already generated layout
+	 * @param LevelProperties Properties to be used
+	 * @param NewLayout Successfully generated layout, kept by the actor for theme regeneration
+	 * @param NewThemeSeed Seed of the theme variant picks
+	 * @param FocusLocation World location rooms are spawned around first with time sliced spawning, e.g. the viewport camera
+	 */
+	void SpawnLayout(UGraphToDungeonProperties* LevelProperties, FDungeonLayout&& NewLayout, const int32 NewThemeSeed,
+		const TOptional<FVector>& FocusLocation = TOptional<FVector>());
+
+	/**
+	 * @brief Picks theme variants again, only instances of tiles whose variant changed are updated
+	 * @param NewThemeSeed Seed of the theme variant picks
+	 */
+	void RegenerateTheme(const int32 NewThemeSeed);
+
+	// Number of components holding at least one instance after the last spawn
+	int32 GetSpawnedComponentCount() const { return SpawnedComponentCount; }
+	// Number of mesh sections drawn by those components, one draw call each
+	int32 GetSpawnedDrawCallCount() const { return SpawnedDrawCallCount; }
+	// True while time sliced spawning still has rooms or corridors queued
+	bool IsSpawning() const { return NextSpawnUnit < SpawnQueue.Num(); }
+};
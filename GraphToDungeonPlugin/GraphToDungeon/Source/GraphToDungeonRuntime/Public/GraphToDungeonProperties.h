@@ -0,0 +1,86 @@
+// Copyright (c) 2024 Richard Pajersky.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "GraphToDungeonTheme.h"
+#include "LevelGraphSession.h"
+#include "GraphToDungeonProperties.generated.h"
+
+DECLARE_DELEGATE(FOnPropertiesEdited)
+
+/**
+ * @brief Represents overall properties used for the generation
+ */
+UCLASS()
+class GRAPHTODUNGEONRUNTIME_API UGraphToDungeonProperties : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	FOnPropertiesEdited OnPropertiesEdited;
+
+#if WITH_EDITOR
+public:
+	/**
+	 * @brief Manages events after changes in editor are made
+	 * @param PropertyChangedEvent Property that has been changed
+	 */
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+	
+public:
+	UPROPERTY(EditAnywhere, Category = "Graph")
+	ULevelGraphSession* LevelGraph;
+
+	UPROPERTY(EditAnywhere, Category = "Theme")
+	int32 ThemeSeed = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Theme")
+	bool bUseRandomThemeSeed = true;
+
+	UPROPERTY(EditAnywhere, Category = "Theme")
+	UGraphToDungeonTheme* GlobalLevelTheme;
+
+	UPROPERTY(EditAnywhere, Category = "Settings")
+	FVector TileSize = FVector(100.f, 100.f, 0);
+
+	UPROPERTY(EditAnywhere, Category = "Settings")
+	int32 RotateTiles = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "0"))
+	int32 MaxCorridorLength = 1000;
+
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "1"))
+	int32 MaxGenerationRetries = 100;
+
+	// Failed room placements and cycle corridors retried locally, by undoing the most recent rooms, before a seed is given up
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "0"))
+	int32 MaxBacktrackingSteps = 50;
+
+	// Reuses layouts of already generated graph, properties and seed combinations stored under Saved/GraphToDungeon/LayoutCache,
+	// only with a fixed theme seed
+	UPROPERTY(EditAnywhere, Category = "Settings")
+	bool bUseLayoutCache = true;
+
+	// Spawns hierarchical instanced components split into square tile chunks, so distant parts are culled separately
+	UPROPERTY(EditAnywhere, Category = "Settings")
+	bool bUseHierarchicalInstancing = false;
+
+	// Chunk edge length in tiles, used with hierarchical instancing only
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "1", EditCondition = "bUseHierarchicalInstancing"))
+	int32 InstanceChunkSize = 32;
+
+	// Spawns rooms and corridors over several frames, nearest to the viewport or player start first
+	UPROPERTY(EditAnywhere, Category = "Settings")
+	bool bTimeSliceSpawning = false;
+
+	// Spawning time per frame, at least one room or corridor is spawned every frame
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "0.1", Units = "ms", EditCondition = "bTimeSliceSpawning"))
+	float SpawnFrameBudgetMs = 4.0f;
+
+	// Instances spawned per frame at most, 0 for no limit
+	UPROPERTY(EditAnywhere, Category = "Settings", meta = (ClampMin = "0", EditCondition = "bTimeSliceSpawning"))
+	int32 SpawnFrameBudgetInstances = 0;
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "UObject/Object.h"
+#include "Engine/DataAsset.h"
 #include "GraphToDungeonTheme.generated.h"
 
 /**
@@ -28,7 +29,7 @@ public:
  * @brief Data asset for defining theme properties
  */
 UCLASS()
-class UGraphToDungeonTheme : public UDataAsset
+class GRAPHTODUNGEONRUNTIME_API UGraphToDungeonTheme : public UDataAsset
 {
 	GENERATED_BODY()
 
@@ -37,7 +38,9 @@ public:
 public:
 	UGraphToDungeonTheme();
 	~UGraphToDungeonTheme();
+#if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 	bool AreMeshesDefined();
 
 public: